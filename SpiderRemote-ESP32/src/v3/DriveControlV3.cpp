@@ -3,6 +3,10 @@
 // =============================================================================
 #include "DriveControlV3.h"
 
+// Vektor-Updates: Mindeständerung und Mindestabstand zwischen zwei moveVec
+static const float VEC_CHANGE_MIN = 0.05f;
+static const uint32_t VEC_SEND_INTERVAL_MS = 60;
+
 void DriveControlV3::begin(WsClientV3* wsClient) {
     ws = wsClient;
     walkParams = WalkParams();  // Defaults
@@ -48,12 +52,18 @@ void DriveControlV3::tick(const InputState& in, int speedMin) {
     // Speed aus speedMax (Poti-Wert, bereits 10..100)
     int desiredSpeed = in.speedMax;
     
-    apply(desiredMove, desiredSpeed, speedMin);
+    if (vectorDrive) {
+        // Alle Achsen gleichzeitig, gleiche Schwellwerte wie oben
+        float vx = (fabsf(joyY) > DEAD_ZONE) ? joyY : 0.0f;
+        float vy = (fabsf(joyX) > DEAD_ZONE) ? joyX : 0.0f;
+        float yaw = (fabsf(turn) > TURN_POTI_THRESHOLD) ? turn : 0.0f;
+        applyVector(desiredMove, vx, vy, yaw, desiredSpeed);
+    } else {
+        apply(desiredMove, desiredSpeed, speedMin);
+    }
 }
 
-void DriveControlV3::apply(MoveDir desiredMove, int desiredSpeed, int speedMin) {
-    if (!ws || !ws->connected()) return;
-    
+void DriveControlV3::sendSpeedAndParams(int desiredSpeed) {
     // Speed-Änderung senden
     if (desiredSpeed != speed) {
         speed = desiredSpeed;
@@ -65,6 +75,43 @@ void DriveControlV3::apply(MoveDir desiredMove, int desiredSpeed, int speedMin)
         ws->sendSetWalkParams(walkParams);
         paramsChanged = false;
     }
+}
+
+void DriveControlV3::applyVector(MoveDir desiredMove, float vx, float vy, float yaw, int desiredSpeed) {
+    if (!ws || !ws->connected()) return;
+    
+    sendSpeedAndParams(desiredSpeed);
+    
+    if (desiredMove == MoveDir::None) {
+        // Stoppen
+        if (moving) {
+            ws->sendMoveStop();
+            moving = false;
+        }
+        move = MoveDir::None;
+        return;
+    }
+    
+    // Vektor nur bei spürbarer Änderung und max. alle VEC_SEND_INTERVAL_MS senden
+    bool changed = fabsf(vx - sentVx) > VEC_CHANGE_MIN ||
+                   fabsf(vy - sentVy) > VEC_CHANGE_MIN ||
+                   fabsf(yaw - sentYaw) > VEC_CHANGE_MIN;
+    uint32_t now = millis();
+    if (!moving || (changed && now - lastVecMs >= VEC_SEND_INTERVAL_MS)) {
+        ws->sendMoveVec(vx, vy, yaw);
+        sentVx = vx;
+        sentVy = vy;
+        sentYaw = yaw;
+        lastVecMs = now;
+        moving = true;
+    }
+    move = desiredMove;
+}
+
+void DriveControlV3::apply(MoveDir desiredMove, int desiredSpeed, int speedMin) {
+    if (!ws || !ws->connected()) return;
+    
+    sendSpeedAndParams(desiredSpeed);
     
     // Bewegungsstatus ändern
     if (desiredMove != move) {
@@ -2,7 +2,8 @@
 // DriveControlV3.h - Erweiterter Drive Controller für v3
 // =============================================================================
 // SpiderRemote-ESP32 v3 Extension
-// Erweitert DriveControl um Walk-Parameter Unterstützung
+// Erweitert DriveControl um Walk-Parameter Unterstützung und
+// kontinuierliche Vektor-Steuerung (moveVec)
 // =============================================================================
 #pragma once
 #include <Arduino.h>
@@ -33,6 +34,10 @@ public:
     // Stride-Steuerung über Poti (0-100 -> 0.5-1.5)
     void updateStrideFromPoti(int potiValue);
     
+    // Vektor-Steuerung: Joystick + Turn-Poti als moveVec statt diskreter Richtung
+    void setVectorDrive(bool enable) { vectorDrive = enable; }
+    bool isVectorDrive() const { return vectorDrive; }
+    
 private:
     WsClientV3* ws = nullptr;
     
@@ -53,6 +58,15 @@ private:
     WalkParams walkParams;
     bool paramsChanged = false;
     
+    // Vektor-Steuerung
+    bool vectorDrive = true;
+    float sentVx = 0.0f;
+    float sentVy = 0.0f;
+    float sentYaw = 0.0f;
+    uint32_t lastVecMs = 0;
+    
+    void sendSpeedAndParams(int desiredSpeed);
     void apply(MoveDir desiredMove, int desiredSpeed, int speedMin);
+    void applyVector(MoveDir desiredMove, float vx, float vy, float yaw, int desiredSpeed);
     const char* moveDirToString(MoveDir dir) const;
 };
@@ -34,6 +34,15 @@ void ServoCalibStore::load(ServoCalibParams* servos, uint8_t count) {
             
             snprintf(key, sizeof(key), "s%d_ctr", i);
             servos[i].centerAngle = prefs.getInt(key, 90);
+            
+            // Punkte aus dem NVS gehören der Remote
+            snprintf(key, sizeof(key), "s%d_pset", i);
+            uint8_t pointsSet = prefs.getUChar(key, 0);
+            for (uint8_t k = 0; k < CALIB_POINT_COUNT; k++) {
+                snprintf(key, sizeof(key), "s%d_p%d", i, k);
+                servos[i].pointUs[k] = prefs.getInt(key, 0);
+                if ((pointsSet >> k) & 1) servos[i].markPoint(k);
+            }
         }
         Serial.println(F("[ServoCalib] Loaded from NVS"));
     }
@@ -59,6 +68,14 @@ void ServoCalibStore::save(const ServoCalibParams* servos, uint8_t count) {
         
         snprintf(key, sizeof(key), "s%d_ctr", i);
         prefs.putInt(key, servos[i].centerAngle);
+        
+        for (uint8_t k = 0; k < CALIB_POINT_COUNT; k++) {
+            snprintf(key, sizeof(key), "s%d_p%d", i, k);
+            prefs.putInt(key, servos[i].pointUs[k]);
+        }
+        
+        snprintf(key, sizeof(key), "s%d_pset", i);
+        prefs.putUChar(key, servos[i].pointsSet);
     }
     
     prefs.end();
@@ -53,6 +53,7 @@ void UiMenuV3::onButtonLeft() {
             
         case MenuModeV3::SERVO_OFFSET:
         case MenuModeV3::SERVO_LIMITS:
+        case MenuModeV3::SERVO_POINTS:
             calibValueDecrease();
             break;
             
@@ -128,6 +129,14 @@ void UiMenuV3::onButtonMiddle() {
         case MenuModeV3::SERVO_LIMITS:
             state.calibParamIndex++;
             if (state.calibParamIndex > 2) {  // min, max, center
+                state.mode = MenuModeV3::SERVO_POINTS;
+                state.calibParamIndex = 0;
+            }
+            break;
+            
+        case MenuModeV3::SERVO_POINTS:
+            state.calibParamIndex++;
+            if (state.calibParamIndex >= CALIB_POINT_COUNT) {
                 applyServoCalib(state.selectedServo);
                 state.mode = MenuModeV3::SERVO_SELECT;
             }
@@ -177,6 +186,7 @@ void UiMenuV3::onButtonRight() {
             
         case MenuModeV3::SERVO_OFFSET:
         case MenuModeV3::SERVO_LIMITS:
+        case MenuModeV3::SERVO_POINTS:
             calibValueIncrease();
             break;
             
@@ -290,6 +300,11 @@ void UiMenuV3::calibValueIncrease() {
     
     if (state.mode == MenuModeV3::SERVO_OFFSET) {
         cal.offset += 1;
+    } else if (state.mode == MenuModeV3::SERVO_POINTS) {
+        // Erster Druck legt einen fehlenden Punkt mit 0 µs an
+        uint8_t k = state.calibParamIndex;
+        if (cal.hasPoint(k)) cal.pointUs[k] += 2;
+        cal.markPoint(k);
     } else {
         switch (state.calibParamIndex) {
             case 0: cal.minAngle += 5; break;
@@ -298,6 +313,7 @@ void UiMenuV3::calibValueIncrease() {
         }
     }
     cal.validate();
+    if (state.mode == MenuModeV3::SERVO_POINTS) sendCalibPoint();
 }
 
 void UiMenuV3::calibValueDecrease() {
@@ -305,6 +321,10 @@ void UiMenuV3::calibValueDecrease() {
     
     if (state.mode == MenuModeV3::SERVO_OFFSET) {
         cal.offset -= 1;
+    } else if (state.mode == MenuModeV3::SERVO_POINTS) {
+        uint8_t k = state.calibParamIndex;
+        if (cal.hasPoint(k)) cal.pointUs[k] -= 2;
+        cal.markPoint(k);
     } else {
         switch (state.calibParamIndex) {
             case 0: cal.minAngle -= 5; break;
@@ -313,6 +333,30 @@ void UiMenuV3::calibValueDecrease() {
         }
     }
     cal.validate();
+    if (state.mode == MenuModeV3::SERVO_POINTS) sendCalibPoint();
+}
+
+// Messpunkt löschen (Long-Press links): der Bot interpoliert dort wieder
+// zwischen den Nachbarpunkten
+void UiMenuV3::clearCalibPoint() {
+    if (state.mode != MenuModeV3::SERVO_POINTS) return;
+    state.servoCalib[state.selectedServo].clearPoint(state.calibParamIndex);
+    sendCalibPoint();
+    state.needsRedraw = true;
+}
+
+// Geänderten Messpunkt live senden: der Bot fährt den Servo auf den Winkel,
+// die Korrektur lässt sich direkt am Bein ablesen. Unveränderte Punkte
+// werden nicht gesendet, sie würden Plätze in der Liste des Bots belegen.
+void UiMenuV3::sendCalibPoint() {
+    if (!ws) return;
+    const ServoCalibParams& cal = state.servoCalib[state.selectedServo];
+    uint8_t k = state.calibParamIndex;
+    if (cal.hasPoint(k)) {
+        ws->sendSetServoCalibPoint(state.selectedServo, CALIB_POINT_ANGLES[k], cal.pointUs[k]);
+    } else {
+        ws->sendRemoveServoCalibPoint(state.selectedServo, CALIB_POINT_ANGLES[k]);
+    }
 }
 
 const char* UiMenuV3::getCalibParamName(int index) {
@@ -516,6 +560,20 @@ void UiMenuV3::getDisplayLines(char* line1, char* line2, char* line3, char* line
             break;
         }
             
+        case MenuModeV3::SERVO_POINTS: {
+            const ServoCalibParams& cal = state.servoCalib[state.selectedServo];
+            snprintf(line1, 21, "SERVO %d PUNKTE", state.selectedServo);
+            snprintf(line2, 21, "> %d Grad (%d/%d)", CALIB_POINT_ANGLES[state.calibParamIndex],
+                state.calibParamIndex + 1, CALIB_POINT_COUNT);
+            if (cal.hasPoint(state.calibParamIndex)) {
+                snprintf(line3, 21, "%+d us", cal.pointUs[state.calibParamIndex]);
+            } else {
+                strcpy(line3, "-- kein Punkt");
+            }
+            strcpy(line4, "[-|lang:DEL][OK][+]");
+            break;
+        }
+            
         case MenuModeV3::ACTIONS:
             strcpy(line1, "= AKTION =");
             snprintf(line2, 21, "> %s", ACTION_LABELS[state.actionIndex]);
@@ -26,6 +26,7 @@ enum class MenuModeV3 : uint8_t {
     SERVO_SELECT,     // Servo auswählen
     SERVO_OFFSET,     // Offset für gewählten Servo
     SERVO_LIMITS,     // Limits für gewählten Servo
+    SERVO_POINTS,     // Messpunkte für gewählten Servo
     ACTIONS,          // Actions (Hello, Dance, etc.)
     TERRAIN           // Terrain-Modus
 };
@@ -44,7 +45,7 @@ struct UiStateV3 {
     // Servo-Kalibrierung
     uint8_t selectedServo;
     ServoCalibParams servoCalib[8];
-    int calibParamIndex;  // 0=offset, 1=min, 2=max, 3=center
+    int calibParamIndex;  // LIMITS: 0=min, 1=max, 2=center; POINTS: Index in CALIB_POINT_ANGLES
     bool servoCalibSaved;  // Lokal gespeichert?
     int servoCalibMenuIndex;  // 0=Select, 1=Grundstellung, 2=Lock/Unlock, 3=Vom Bot laden, 4=Save Local, 5=Send to Bot
     bool calibLocked;  // Kalibrierungs-Lock Status
@@ -113,6 +114,9 @@ public:
     void onButtonMiddle();
     void onButtonRight();
     
+    // Long-Press links im SERVO_POINTS-Menü: Messpunkt löschen
+    void clearCalibPoint();
+    
     // Poti-Handler für Wertänderung im aktuellen Menü
     void onPotiChange(int value);  // 0-100
     
@@ -172,6 +176,7 @@ private:
     void calibParamDown();
     void calibValueIncrease();
     void calibValueDecrease();
+    void sendCalibPoint();
     
     // Helper
     const char* getWalkParamName(int index);
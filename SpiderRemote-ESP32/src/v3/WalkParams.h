@@ -65,17 +65,46 @@ struct WalkParams {
 // =============================================================================
 // Servo-Kalibrierungs-Parameter
 // =============================================================================
+// Messpunkte: feste Winkel, pro Punkt eine Korrektur in µs zusätzlich zum
+// Offset (der Bot interpoliert dazwischen linear)
+static const uint8_t CALIB_POINT_COUNT = 5;
+static const int CALIB_POINT_ANGLES[CALIB_POINT_COUNT] = { 30, 60, 90, 120, 150 };
+static const int CALIB_POINT_LIMIT_US = 333;   // wie Offset ±30°
+
 struct ServoCalibParams {
     int offset;       // Offset-Korrektur
     int minAngle;     // Minimaler sicherer Winkel
     int maxAngle;     // Maximaler sicherer Winkel
     int centerAngle;  // Neutralpunkt
+    int pointUs[CALIB_POINT_COUNT];  // Korrektur bei CALIB_POINT_ANGLES (µs)
+    uint8_t pointsSet;    // Bitmaske: Punkt vorhanden (auch mit 0 µs, z.B. als Anker)
+    uint8_t pointsOwned;  // Bitmaske: auf der Remote bearbeitet oder aus NVS
     
     ServoCalibParams() 
         : offset(0)
         , minAngle(20)
         , maxAngle(160)
-        , centerAngle(90) {}
+        , centerAngle(90)
+        , pointsSet(0)
+        , pointsOwned(0) {
+        for (uint8_t k = 0; k < CALIB_POINT_COUNT; k++) pointUs[k] = 0;
+    }
+    
+    // Nur eigene Punkte gehen an den Bot, seine übrigen Punkte (z.B. aus
+    // dem Web-UI, auch abseits des Rasters) bleiben erhalten
+    bool ownsPoint(uint8_t k) const { return (pointsOwned >> k) & 1; }
+    bool hasPoint(uint8_t k) const { return (pointsSet >> k) & 1; }
+    
+    // Punkt auf der Remote anlegen/ändern bzw. ausdrücklich löschen
+    void markPoint(uint8_t k) {
+        pointsSet |= (uint8_t)(1 << k);
+        pointsOwned |= (uint8_t)(1 << k);
+    }
+    void clearPoint(uint8_t k) {
+        pointUs[k] = 0;
+        pointsSet &= (uint8_t)~(1 << k);
+        pointsOwned |= (uint8_t)(1 << k);
+    }
     
     void validate() {
         if (offset < -30) offset = -30;
@@ -84,5 +113,10 @@ struct ServoCalibParams {
         if (maxAngle > 180) maxAngle = 180;
         if (centerAngle < minAngle) centerAngle = minAngle;
         if (centerAngle > maxAngle) centerAngle = maxAngle;
+        for (uint8_t k = 0; k < CALIB_POINT_COUNT; k++) {
+            if (!hasPoint(k)) pointUs[k] = 0;
+            if (pointUs[k] < -CALIB_POINT_LIMIT_US) pointUs[k] = -CALIB_POINT_LIMIT_US;
+            if (pointUs[k] > CALIB_POINT_LIMIT_US) pointUs[k] = CALIB_POINT_LIMIT_US;
+        }
     }
 };
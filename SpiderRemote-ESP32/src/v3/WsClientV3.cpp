@@ -60,6 +60,15 @@ void WsClientV3::sendMoveStartEx(const char* name, const WalkParams* override) {
     }
 }
 
+void WsClientV3::sendMoveVec(float vx, float vy, float yaw) {
+    char buf[80];
+    snprintf(buf, sizeof(buf),
+        "{\"type\":\"moveVec\",\"vx\":%.2f,\"vy\":%.2f,\"yaw\":%.2f}",
+        vx, vy, yaw
+    );
+    sendImmediate(buf);
+}
+
 void WsClientV3::sendSetStride(float stride) {
     currentParams.stride = stride;
     currentParams.validate();
@@ -160,16 +169,55 @@ void WsClientV3::sendSetServoCalib(uint8_t servo, const ServoCalibParams& params
     ServoCalibParams validated = params;
     validated.validate();
     
-    char buf[160];
-    snprintf(buf, sizeof(buf), 
+    char buf[256];
+    int len = snprintf(buf, sizeof(buf), 
         "{\"type\":\"setServoCalib\",\"servo\":%d,"
-        "\"offset\":%d,\"min\":%d,\"max\":%d,\"center\":%d}", 
+        "\"offset\":%d,\"min\":%d,\"max\":%d,\"center\":%d", 
         servo, 
         validated.offset, 
         validated.minAngle, 
         validated.maxAngle, 
         validated.centerAngle
     );
+    
+    // Eigene Punkte mit der Liste des Bots zusammenführen (gelöschte
+    // entfernen), ohne eigene Punkte bleibt seine Liste unverändert
+    int merged = 0;
+    for (uint8_t k = 0; k < CALIB_POINT_COUNT; k++) {
+        if (!validated.ownsPoint(k) || !validated.hasPoint(k)) continue;
+        len += snprintf(buf + len, sizeof(buf) - len, "%s[%d,%d]",
+            merged++ ? "," : ",\"mergePoints\":[", CALIB_POINT_ANGLES[k], validated.pointUs[k]);
+    }
+    if (merged) len += snprintf(buf + len, sizeof(buf) - len, "]");
+    
+    int removed = 0;
+    for (uint8_t k = 0; k < CALIB_POINT_COUNT; k++) {
+        if (!validated.ownsPoint(k) || validated.hasPoint(k)) continue;
+        len += snprintf(buf + len, sizeof(buf) - len, "%s%d",
+            removed++ ? "," : ",\"removePoints\":[", CALIB_POINT_ANGLES[k]);
+    }
+    if (removed) len += snprintf(buf + len, sizeof(buf) - len, "]");
+    snprintf(buf + len, sizeof(buf) - len, "}");
+    sendImmediate(buf);
+}
+
+void WsClientV3::sendSetServoCalibPoint(uint8_t servo, int angle, int us) {
+    if (servo >= 8) return;
+    
+    char buf[96];
+    snprintf(buf, sizeof(buf),
+        "{\"type\":\"setServoCalib\",\"servo\":%d,\"point\":[%d,%d]}",
+        servo, angle, us);
+    sendImmediate(buf);
+}
+
+void WsClientV3::sendRemoveServoCalibPoint(uint8_t servo, int angle) {
+    if (servo >= 8) return;
+    
+    char buf[96];
+    snprintf(buf, sizeof(buf),
+        "{\"type\":\"setServoCalib\",\"servo\":%d,\"removePoint\":%d}",
+        servo, angle);
     sendImmediate(buf);
 }
 
@@ -201,6 +249,19 @@ void WsClientV3::sendGetServoCalib() {
 // =============================================================================
 #include <ArduinoJson.h>
 
+// Messpunkte [[Grad, µs], ...] vom Bot: nur die festen Winkel der Remote
+// werden übernommen
+static void readCalibPoints(JsonArrayConst points, ServoCalibParams& params) {
+    for (JsonVariantConst p : points) {
+        int angle = p[0] | -1;
+        for (uint8_t k = 0; k < CALIB_POINT_COUNT; k++) {
+            if (CALIB_POINT_ANGLES[k] != angle) continue;
+            params.pointUs[k] = p[1] | 0;
+            params.pointsSet |= (uint8_t)(1 << k);
+        }
+    }
+}
+
 void WsClientV3::processResponse(const char* json) {
     if (!json) return;
     
@@ -223,6 +284,7 @@ void WsClientV3::processResponse(const char* json) {
             params.minAngle = doc["min"] | 20;
             params.maxAngle = doc["max"] | 160;
             params.centerAngle = doc["center"] | 90;
+            readCalibPoints(doc["points"].as<JsonArrayConst>(), params);
             params.validate();
             
             servoCalibCallback(servo, params);
@@ -240,6 +302,7 @@ void WsClientV3::processResponse(const char* json) {
                 params.minAngle = s["min"] | 20;
                 params.maxAngle = s["max"] | 160;
                 params.centerAngle = s["center"] | 90;
+                readCalibPoints(s["points"].as<JsonArrayConst>(), params);
                 params.validate();
                 
                 servoCalibCallback(i, params);
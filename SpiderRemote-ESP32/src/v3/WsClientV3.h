@@ -5,6 +5,7 @@
 // Erweitert WsClient um:
 //   - setWalkParams Command
 //   - moveStartEx mit optionalen Parametern
+//   - moveVec (kontinuierlicher Bewegungsvektor)
 //   - Servo-Kalibrierungs-Commands
 // =============================================================================
 #pragma once
@@ -24,6 +25,9 @@ public:
     // Erweiterte moveStart mit optionalen Parameter-Overrides
     void sendMoveStartEx(const char* name, const WalkParams* override = nullptr);
     
+    // Bewegungsvektor (je -1..+1): vx vor/zurück, vy rechts/links, yaw drehen
+    void sendMoveVec(float vx, float vy, float yaw);
+    
     // Einzelne Parameter ändern
     void sendSetStride(float stride);
     void sendSetSubSteps(uint8_t steps);
@@ -42,9 +46,13 @@ public:
     // Limits für einen Servo setzen
     void sendSetServoLimits(uint8_t servo, int minAngle, int maxAngle, int centerAngle);
     
-    // Alle Kalibrierungsdaten eines Servos setzen
+    // Alle Kalibrierungsdaten eines Servos setzen (inkl. eigener Messpunkte)
     void sendSetServoCalib(uint8_t servo, const ServoCalibParams& params);
     
+    // Einzelnen Messpunkt setzen, der Bot fährt den Servo zum Messen hin
+    void sendSetServoCalibPoint(uint8_t servo, int angle, int us);
+    void sendRemoveServoCalibPoint(uint8_t servo, int angle);
+    
     // Kalibrierung speichern/laden anfordern
     void sendSaveCalib();
     void sendLoadCalib();
@@ -362,6 +362,7 @@ void loop() {
     // Button-Events an Menü weiterleiten
     if (evL == PressType::Short) uiMenu.onButtonLeft();
     if (evR == PressType::Short) uiMenu.onButtonRight();
+    if (evL == PressType::Long) uiMenu.clearCalibPoint();
     
     // MID-Button: im MOTION-Mode Kalibrierung starten, im INPUT_CALIB Mode weiter
     if (evM == PressType::Short) {
@@ -416,6 +417,7 @@ void loop() {
             case MenuModeV3::SERVO_SELECT:
             case MenuModeV3::SERVO_OFFSET:
             case MenuModeV3::SERVO_LIMITS:
+            case MenuModeV3::SERVO_POINTS:
                 state.mode = MenuModeV3::ACTIONS;
                 break;
             case MenuModeV3::ACTIONS:
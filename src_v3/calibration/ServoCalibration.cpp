@@ -3,6 +3,7 @@
 // =============================================================================
 #include "ServoCalibration.h"
 #include "../gait/GaitRuntime.h"
+#include "../motion/MotionData_v3.h"
 #include <LittleFS.h>
 
 namespace ServoCalibration {
@@ -11,8 +12,81 @@ namespace ServoCalibration {
 // Statische Daten
 // =============================================================================
 static CalibrationData calibData;
+uint16_t pulseTableQ4[SERVO_COUNT][PULSE_TABLE_SIZE];
 static const char* CALIB_FILE = "/servo_calib_v3.dat";
-static const uint32_t MAGIC = 0x53564F33;  // "SVO3"
+static const uint32_t MAGIC = 0x53564F34;         // "SVO4" (Offsets in µs)
+static const uint32_t MAGIC_V3_DEG = 0x53564F33;  // "SVO3" (Offsets in Grad)
+static const int OFFSET_LIMIT_DEG = 30;
+
+// Grad-Offset <-> µs-Offset (gleiche Skalierung wie fineToUs)
+static const int PULSE_RANGE_US = SERVO_PULSE_MAX_US - SERVO_PULSE_MIN_US;
+
+static int offsetDegToUs(int deg) {
+    return (deg * PULSE_RANGE_US + (deg >= 0 ? 90 : -90)) / 180;
+}
+
+static int offsetUsToDeg(int us) {
+    return (us * 180 + (us >= 0 ? PULSE_RANGE_US / 2 : -PULSE_RANGE_US / 2)) / PULSE_RANGE_US;
+}
+
+// =============================================================================
+// Ausgabetabelle erzeugen
+// =============================================================================
+// Pulsbreite in 1/16 µs für einen Winkel in ganzen Grad (wie fineToUs)
+static int degToPulseQ4(int deg) {
+    return (SERVO_PULSE_MIN_US << 4) + (deg * PULSE_RANGE_US * 16 + 90) / 180;
+}
+
+// Korrektur der Messpunkte bei deg in 1/16 µs (stückweise linear)
+static int pointCorrectionQ4(uint8_t servo, int deg) {
+    const uint8_t count = calibData.pointCount[servo];
+    if (count == 0) return 0;
+    
+    const CalibPoint* pts = calibData.points[servo];
+    if (deg <= pts[0].angle) return pts[0].us << 4;
+    if (deg >= pts[count - 1].angle) return pts[count - 1].us << 4;
+    
+    uint8_t k = 1;
+    while (pts[k].angle < deg) k++;
+    const CalibPoint& a = pts[k - 1];
+    const CalibPoint& b = pts[k];
+    int span = b.angle - a.angle;
+    int num = (b.us - a.us) * (deg - a.angle) * 16;
+    return (a.us << 4) + (num + (num >= 0 ? span / 2 : -span / 2)) / span;
+}
+
+static void compileTable(uint8_t servo) {
+    const ServoLimits& lim = calibData.limits[servo];
+    const int safeMinQ4 = degToPulseQ4(PWMRES_Min);
+    const int safeMaxQ4 = degToPulseQ4(PWMRES_Max);
+    
+    for (int d = 0; d < PULSE_TABLE_SIZE; d++) {
+        int deg = d > 180 ? 180 : d;
+        if (deg < lim.minAngle) deg = lim.minAngle;
+        if (deg > lim.maxAngle) deg = lim.maxAngle;
+        
+        int q4 = degToPulseQ4(deg) + (calibData.offsetUs[servo] << 4)
+               + pointCorrectionQ4(servo, deg);
+        if (q4 < safeMinQ4) q4 = safeMinQ4;
+        if (q4 > safeMaxQ4) q4 = safeMaxQ4;
+        pulseTableQ4[servo][d] = (uint16_t)q4;
+    }
+}
+
+// Nach jeder Änderung: Tabellen neu erzeugen und die Limits an die
+// Gait-Planung weitergeben (nur geänderte, jede Änderung leert den Segment-Cache)
+static void apply() {
+    for (uint8_t i = 0; i < SERVO_COUNT; i++) {
+        compileTable(i);
+        
+        const ServoLimits& lim = calibData.limits[i];
+        const ServoLimits& gait = gaitConfig.servoLimits[i];
+        if (gait.minAngle != lim.minAngle || gait.maxAngle != lim.maxAngle ||
+            gait.centerAngle != lim.centerAngle) {
+            GaitRuntime::setServoLimits(i, lim.minAngle, lim.maxAngle, lim.centerAngle);
+        }
+    }
+}
 
 // =============================================================================
 // Initialisierung
@@ -25,15 +99,13 @@ void init() {
         // Standard-Werte setzen basierend auf bekannter Mechanik
         // Diese können später per Remote angepasst werden
         for (uint8_t i = 0; i < SERVO_COUNT; i++) {
-            calibData.offset[i] = 0;
-            calibData.limits[i] = ServoLimits(20, 160, 90);
+            calibData.offsetUs[i] = 0;
+            calibData.limits[i] = ServoLimits();
         }
         calibData.valid = true;
+        apply();
     }
     
-    // Mit GaitConfig synchronisieren
-    syncToGaitConfig();
-    
     printAll();
 }
 
@@ -44,25 +116,133 @@ void setOffset(uint8_t servo, int value) {
     if (servo >= SERVO_COUNT) return;
     
     // Clamp auf sinnvollen Bereich
-    if (value < -30) value = -30;
-    if (value > 30) value = 30;
+    if (value < -OFFSET_LIMIT_DEG) value = -OFFSET_LIMIT_DEG;
+    if (value > OFFSET_LIMIT_DEG) value = OFFSET_LIMIT_DEG;
     
-    calibData.offset[servo] = value;
-    Serial.printf("[ServoCalib] Offset[%d] = %d\n", servo, value);
+    calibData.offsetUs[servo] = offsetDegToUs(value);
+    compileTable(servo);
+    Serial.printf("[ServoCalib] Offset[%d] = %d (%d us)\n", servo, value, calibData.offsetUs[servo]);
 }
 
 int getOffset(uint8_t servo) {
     if (servo >= SERVO_COUNT) return 0;
-    return calibData.offset[servo];
+    return offsetUsToDeg(calibData.offsetUs[servo]);
+}
+
+void setOffsetUs(uint8_t servo, int us) {
+    if (servo >= SERVO_COUNT) return;
+    
+    // Gleicher Bereich wie in Grad (±30°)
+    const int limitUs = offsetDegToUs(OFFSET_LIMIT_DEG);
+    if (us < -limitUs) us = -limitUs;
+    if (us > limitUs) us = limitUs;
+    
+    calibData.offsetUs[servo] = us;
+    compileTable(servo);
+    Serial.printf("[ServoCalib] Offset[%d] = %d us\n", servo, us);
+}
+
+int getOffsetUs(uint8_t servo) {
+    if (servo >= SERVO_COUNT) return 0;
+    return calibData.offsetUs[servo];
 }
 
 void resetOffsets() {
     for (uint8_t i = 0; i < SERVO_COUNT; i++) {
-        calibData.offset[i] = 0;
+        calibData.offsetUs[i] = 0;
+        calibData.pointCount[i] = 0;
+        compileTable(i);
     }
     Serial.println(F("[ServoCalib] Offsets zurückgesetzt"));
 }
 
+// =============================================================================
+// Messpunkte
+// =============================================================================
+static int clampPointUs(int us) {
+    const int limitUs = offsetDegToUs(OFFSET_LIMIT_DEG);
+    if (us < -limitUs) return -limitUs;
+    if (us > limitUs) return limitUs;
+    return us;
+}
+
+// Punkt einsortieren bzw. ersetzen, ohne Tabelle neu zu erzeugen
+static bool insertPoint(uint8_t servo, int angle, int us) {
+    if (angle < 0) angle = 0;
+    if (angle > 180) angle = 180;
+    us = clampPointUs(us);
+    
+    CalibPoint* pts = calibData.points[servo];
+    uint8_t& count = calibData.pointCount[servo];
+    uint8_t k = 0;
+    while (k < count && pts[k].angle < angle) k++;
+    if (k < count && pts[k].angle == angle) {
+        pts[k].us = (int16_t)us;
+        return true;
+    }
+    if (count >= CALIB_MAX_POINTS) return false;
+    
+    for (uint8_t j = count; j > k; j--) {
+        pts[j] = pts[j - 1];
+    }
+    pts[k].angle = (int16_t)angle;
+    pts[k].us = (int16_t)us;
+    count++;
+    return true;
+}
+
+bool setPoint(uint8_t servo, int angle, int us) {
+    if (servo >= SERVO_COUNT) return false;
+    
+    if (!insertPoint(servo, angle, us)) {
+        Serial.printf("[ServoCalib] Punkt[%d] %d Grad: alle %d Punkte belegt\n",
+            servo, angle, CALIB_MAX_POINTS);
+        return false;
+    }
+    compileTable(servo);
+    Serial.printf("[ServoCalib] Punkt[%d] %d Grad = %+d us\n", servo, angle, us);
+    return true;
+}
+
+void removePoint(uint8_t servo, int angle) {
+    if (servo >= SERVO_COUNT) return;
+    
+    CalibPoint* pts = calibData.points[servo];
+    uint8_t& count = calibData.pointCount[servo];
+    for (uint8_t k = 0; k < count; k++) {
+        if (pts[k].angle != angle) continue;
+        for (uint8_t j = k; j + 1 < count; j++) {
+            pts[j] = pts[j + 1];
+        }
+        count--;
+        compileTable(servo);
+        Serial.printf("[ServoCalib] Punkt[%d] %d Grad entfernt\n", servo, angle);
+        return;
+    }
+}
+
+void setPoints(uint8_t servo, const CalibPoint points[], uint8_t count) {
+    if (servo >= SERVO_COUNT) return;
+    
+    calibData.pointCount[servo] = 0;
+    for (uint8_t k = 0; k < count; k++) {
+        insertPoint(servo, points[k].angle, points[k].us);
+    }
+    compileTable(servo);
+    Serial.printf("[ServoCalib] Punkte[%d]: %d\n", servo, calibData.pointCount[servo]);
+}
+
+uint8_t getPointCount(uint8_t servo) {
+    if (servo >= SERVO_COUNT) return 0;
+    return calibData.pointCount[servo];
+}
+
+CalibPoint getPoint(uint8_t servo, uint8_t index) {
+    CalibPoint p = { 0, 0 };
+    if (servo >= SERVO_COUNT || index >= calibData.pointCount[servo]) return p;
+    return calibData.points[servo][index];
+}
+
 // =============================================================================
 // Limits-Verwaltung
 // =============================================================================
@@ -82,9 +262,7 @@ void setLimits(uint8_t servo, int minAngle, int maxAngle, int centerAngle) {
     calibData.limits[servo].minAngle = minAngle;
     calibData.limits[servo].maxAngle = maxAngle;
     calibData.limits[servo].centerAngle = centerAngle;
-    
-    // Sofort mit GaitConfig synchronisieren
-    GaitRuntime::setServoLimits(servo, minAngle, maxAngle, centerAngle);
+    apply();
     
     Serial.printf("[ServoCalib] Limits[%d]: min=%d, max=%d, center=%d\n", 
         servo, minAngle, maxAngle, centerAngle);
@@ -105,29 +283,31 @@ int getCenterAngle(uint8_t servo) {
     return calibData.limits[servo].centerAngle;
 }
 
-void resetLimits() {
-    for (uint8_t i = 0; i < SERVO_COUNT; i++) {
-        calibData.limits[i] = ServoLimits(20, 160, 90);
-    }
-    syncToGaitConfig();
-    Serial.println(F("[ServoCalib] Limits zurückgesetzt"));
+void setLimitsUs(uint8_t servo, int minUs, int maxUs, int centerUs) {
+    setLimits(servo,
+        fineToDeg(usToFine(minUs)),
+        fineToDeg(usToFine(maxUs)),
+        fineToDeg(usToFine(centerUs)));
 }
 
-// =============================================================================
-// Winkel-Transformation
-// =============================================================================
-int applyOffset(uint8_t servo, int rawAngle) {
-    if (servo >= SERVO_COUNT) return rawAngle;
-    return rawAngle + calibData.offset[servo];
+int getMinUs(uint8_t servo) {
+    return fineToUs(degToFine(getMinAngle(servo)));
 }
 
-int clampToLimits(uint8_t servo, int angle) {
-    if (servo >= SERVO_COUNT) return angle;
-    
-    const ServoLimits& lim = calibData.limits[servo];
-    if (angle < lim.minAngle) return lim.minAngle;
-    if (angle > lim.maxAngle) return lim.maxAngle;
-    return angle;
+int getMaxUs(uint8_t servo) {
+    return fineToUs(degToFine(getMaxAngle(servo)));
+}
+
+int getCenterUs(uint8_t servo) {
+    return fineToUs(degToFine(getCenterAngle(servo)));
+}
+
+void resetLimits() {
+    for (uint8_t i = 0; i < SERVO_COUNT; i++) {
+        calibData.limits[i] = ServoLimits();
+    }
+    apply();
+    Serial.println(F("[ServoCalib] Limits zurückgesetzt"));
 }
 
 // =============================================================================
@@ -143,14 +323,18 @@ bool save() {
     // Magic schreiben
     f.write((uint8_t*)&MAGIC, sizeof(MAGIC));
     
-    // Offsets
-    f.write((uint8_t*)calibData.offset, sizeof(calibData.offset));
+    // Offsets (µs)
+    f.write((uint8_t*)calibData.offsetUs, sizeof(calibData.offsetUs));
     
     // Limits
     for (uint8_t i = 0; i < SERVO_COUNT; i++) {
         f.write((uint8_t*)&calibData.limits[i], sizeof(ServoLimits));
     }
     
+    // Messpunkte (angehängt, ältere Dateien enden vorher)
+    f.write(calibData.pointCount, sizeof(calibData.pointCount));
+    f.write((uint8_t*)calibData.points, sizeof(calibData.points));
+    
     f.close();
     Serial.println(F("[ServoCalib] Gespeichert"));
     return true;
@@ -165,50 +349,60 @@ bool load() {
     // Magic prüfen
     uint32_t magic = 0;
     f.read((uint8_t*)&magic, sizeof(magic));
-    if (magic != MAGIC) {
+    if (magic != MAGIC && magic != MAGIC_V3_DEG) {
         Serial.println(F("[ServoCalib] Datei-Version ungültig"));
         f.close();
         return false;
     }
     
-    // Offsets laden
-    f.read((uint8_t*)calibData.offset, sizeof(calibData.offset));
+    // Offsets laden (alte Dateien in Grad -> µs migrieren)
+    f.read((uint8_t*)calibData.offsetUs, sizeof(calibData.offsetUs));
+    if (magic == MAGIC_V3_DEG) {
+        for (uint8_t i = 0; i < SERVO_COUNT; i++) {
+            calibData.offsetUs[i] = offsetDegToUs(calibData.offsetUs[i]);
+        }
+        Serial.println(F("[ServoCalib] Offsets von Grad nach µs migriert"));
+    }
     
     // Limits laden
     for (uint8_t i = 0; i < SERVO_COUNT; i++) {
         f.read((uint8_t*)&calibData.limits[i], sizeof(ServoLimits));
     }
     
+    // Messpunkte
+    for (uint8_t i = 0; i < SERVO_COUNT; i++) {
+        calibData.pointCount[i] = 0;
+    }
+    if (f.available() >= (int)(sizeof(calibData.pointCount) + sizeof(calibData.points))) {
+        f.read(calibData.pointCount, sizeof(calibData.pointCount));
+        f.read((uint8_t*)calibData.points, sizeof(calibData.points));
+        for (uint8_t i = 0; i < SERVO_COUNT; i++) {
+            if (calibData.pointCount[i] > CALIB_MAX_POINTS) calibData.pointCount[i] = 0;
+        }
+    }
+    
     f.close();
     calibData.valid = true;
+    apply();
     Serial.println(F("[ServoCalib] Geladen"));
     return true;
 }
 
-// =============================================================================
-// Synchronisierung mit GaitConfig
-// =============================================================================
-void syncToGaitConfig() {
-    for (uint8_t i = 0; i < SERVO_COUNT; i++) {
-        GaitRuntime::setServoLimits(i, 
-            calibData.limits[i].minAngle,
-            calibData.limits[i].maxAngle,
-            calibData.limits[i].centerAngle);
-    }
-    Serial.println(F("[ServoCalib] Mit GaitConfig synchronisiert"));
-}
-
 // =============================================================================
 // Debug
 // =============================================================================
 void printAll() {
     Serial.println(F("=== Servo-Kalibrierung ==="));
     for (uint8_t i = 0; i < SERVO_COUNT; i++) {
-        Serial.printf("  [%d] offset=%+3d, min=%3d, max=%3d, center=%3d\n",
-            i, calibData.offset[i],
+        Serial.printf("  [%d] offset=%+4dus, min=%3d, max=%3d, center=%3d",
+            i, calibData.offsetUs[i],
             calibData.limits[i].minAngle,
             calibData.limits[i].maxAngle,
             calibData.limits[i].centerAngle);
+        for (uint8_t k = 0; k < calibData.pointCount[i]; k++) {
+            Serial.printf(", %d:%+dus", calibData.points[i][k].angle, calibData.points[i][k].us);
+        }
+        Serial.println();
     }
     Serial.println(F("=========================="));
 }
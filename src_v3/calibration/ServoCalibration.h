@@ -3,10 +3,15 @@
 // =============================================================================
 // v3 Calibration Module für ESP8266 Spider Controller
 // Features:
-//   - Offset pro Servo
-//   - Min/Max/Center Limits pro Servo
+//   - Offset pro Servo (intern in µs, in Grad oder µs setzbar)
+//   - Bis zu CALIB_MAX_POINTS Messpunkte pro Servo: Korrektur in µs bei einem
+//     Winkel, dazwischen linear (für nichtlineare Servos)
+//   - Min/Max/Center Limits pro Servo (Grad oder µs)
 //   - Persistenz in LittleFS
 //   - Live-Anpassung über WebSocket
+//   - Ausgabetabelle pro Servo: Offset und Limits eingerechnet, bei jeder
+//     Änderung neu erzeugt. Einzige Quelle der Limits, gaitConfig.servoLimits
+//     ist nur eine Kopie für die Gait-Planung.
 // =============================================================================
 #ifndef SERVO_CALIBRATION_H
 #define SERVO_CALIBRATION_H
@@ -19,20 +24,50 @@ namespace ServoCalibration {
 // =============================================================================
 // Kalibrierungs-Datenstruktur (erweitert)
 // =============================================================================
+static const uint8_t CALIB_MAX_POINTS = 5;
+
+// Messpunkt: bei angle (Grad) braucht der Servo zusätzlich zum Offset us µs
+struct CalibPoint {
+    int16_t angle;
+    int16_t us;
+};
+
 struct CalibrationData {
-    int offset[SERVO_COUNT];           // Offset-Korrektur pro Servo
+    int offsetUs[SERVO_COUNT];         // Offset-Korrektur pro Servo in µs
     ServoLimits limits[SERVO_COUNT];   // Min/Max/Center pro Servo
+    CalibPoint points[SERVO_COUNT][CALIB_MAX_POINTS];  // Nach Winkel sortiert
+    uint8_t pointCount[SERVO_COUNT];
     bool valid;                        // Magic-Check für Dateivalidierung
     
     CalibrationData() {
         valid = false;
         for (uint8_t i = 0; i < SERVO_COUNT; i++) {
-            offset[i] = 0;
-            limits[i] = ServoLimits(20, 160, 90);  // Konservative Defaults
+            offsetUs[i] = 0;
+            limits[i] = ServoLimits();  // Konservative Defaults
+            pointCount[i] = 0;
         }
     }
 };
 
+// =============================================================================
+// Ausgabetabelle: Winkel in ganzen Grad -> Pulsbreite in 1/16 µs
+// =============================================================================
+// Einträge außerhalb der Limits halten den Limit-Puls, Offset, Messpunkte und
+// PWM-Sicherheitsbereich sind eingerechnet. Zwischen zwei Grad wird linear
+// interpoliert (Sub-Grad-Ausgabe).
+static const int PULSE_TABLE_SIZE = 182;   // 0-180 Grad + Stützstelle für 180 Grad
+extern uint16_t pulseTableQ4[SERVO_COUNT][PULSE_TABLE_SIZE];
+
+// Winkel (1/16 Grad) -> Pulsbreite (µs)
+inline int fineToPulseUs(uint8_t servo, int fineAngle) {
+    if (fineAngle < 0) fineAngle = 0;
+    if (fineAngle > degToFine(180)) fineAngle = degToFine(180);
+    const uint16_t* entry = &pulseTableQ4[servo][fineAngle >> ANGLE_FINE_SHIFT];
+    int frac = fineAngle & (ANGLE_FINE_ONE - 1);
+    int32_t q8 = ((int32_t)entry[0] << ANGLE_FINE_SHIFT) + ((int32_t)entry[1] - entry[0]) * frac;
+    return (int)((q8 + 128) >> 8);
+}
+
 // =============================================================================
 // API
 // =============================================================================
@@ -40,11 +75,23 @@ struct CalibrationData {
 // Initialisierung (lädt gespeicherte Daten)
 void init();
 
-// Offset-Verwaltung
+// Offset-Verwaltung (Grad: gerundet, µs: volle Auflösung)
 void setOffset(uint8_t servo, int value);
 int getOffset(uint8_t servo);
+void setOffsetUs(uint8_t servo, int us);
+int getOffsetUs(uint8_t servo);
 void resetOffsets();
 
+// Messpunkte (Grad, µs zusätzlich zum Offset). Vor dem ersten und nach dem
+// letzten Punkt gilt dessen Korrektur, dazwischen wird linear interpoliert.
+// setPoint: Punkt bei angle anlegen oder ersetzen (false = alle belegt)
+bool setPoint(uint8_t servo, int angle, int us);
+void removePoint(uint8_t servo, int angle);
+// Alle Punkte eines Servos ersetzen (count = 0 löscht)
+void setPoints(uint8_t servo, const CalibPoint points[], uint8_t count);
+uint8_t getPointCount(uint8_t servo);
+CalibPoint getPoint(uint8_t servo, uint8_t index);
+
 // Limits-Verwaltung
 void setLimits(uint8_t servo, int minAngle, int maxAngle, int centerAngle);
 int getMinAngle(uint8_t servo);
@@ -52,11 +99,11 @@ int getMaxAngle(uint8_t servo);
 int getCenterAngle(uint8_t servo);
 void resetLimits();
 
-// Offset auf Winkel anwenden (wird von Set_PWM_to_Servo genutzt)
-int applyOffset(uint8_t servo, int rawAngle);
-
-// Winkel auf Limits clampen
-int clampToLimits(uint8_t servo, int angle);
+// Limits in µs (werden auf ganze Grad gerundet gespeichert)
+void setLimitsUs(uint8_t servo, int minUs, int maxUs, int centerUs);
+int getMinUs(uint8_t servo);
+int getMaxUs(uint8_t servo);
+int getCenterUs(uint8_t servo);
 
 // Persistenz
 bool save();
@@ -68,9 +115,6 @@ void printAll();
 // Gesamte Kalibrierungsdaten holen (für WebSocket-Antwort)
 const CalibrationData& getData();
 
-// Kalibrierung mit GaitConfig synchronisieren
-void syncToGaitConfig();
-
 } // namespace ServoCalibration
 
 #endif // SERVO_CALIBRATION_H
@@ -0,0 +1,284 @@
+// =============================================================================
+// CpgGait.cpp - Implementierung des parametrischen Gait-Generators
+// =============================================================================
+#include "CpgGait.h"
+#include "GaitRuntime.h"
+#include "LegIK.h"
+
+// Externe Abhängigkeiten (aus MotionData)
+extern int speedMultiplier;
+
+namespace CpgGait {
+
+// =============================================================================
+// Bein-Geometrie
+// =============================================================================
+struct CpgLeg {
+    uint8_t hipIdx;
+    uint8_t kneeIdx;
+    int8_t hipSign;    // +1: Swing bewegt Hip zu größeren Winkeln
+    int8_t turnSign;   // Anteil an Rechtsdrehung (rechte Seite rückwärts)
+    int8_t strafeSign; // Anteil an Rechts-Seitwärts (diagonal gegenläufig)
+    bool front;        // IK: vorderes Bein
+    int8_t outSign;    // IK: +1 = rechte Seite (außen = Körper-y)
+};
+
+// Reihenfolge wie CpgConfig::phaseOffset: UR, LR, UL, LL
+// Vorzeichen aus Servo_Prg_2 (vor), Servo_Prg_5 (rechts) und Servo_Prg_7 (rechts drehen)
+static const CpgLeg LEGS[LEG_COUNT] = {
+    { 1, 0, +1, -1, -1, true,  +1 },   // UR
+    { 2, 3, +1, -1, +1, false, +1 },   // LR
+    { 5, 4, -1, +1, +1, true,  -1 },   // UL
+    { 6, 7, -1, +1, -1, false, -1 },   // LL
+};
+
+// Neutralpose = erster Keyframe von Servo_Prg_2
+static const int NEUTRAL_POSE[SERVO_COUNT] = { 78, 90, 90, 106, 106, 90, 90, 78 };
+
+// Überblendung von der Startpose in den Oszillator
+static const uint16_t ENTRY_BLEND_MS = 200;
+
+// Längster berücksichtigter Tick-Abstand (z.B. nach blockierendem Code)
+static const unsigned long MAX_DT_MS = 100;
+
+static const uint32_t PHASE_ONE = 1UL << 16;
+
+// =============================================================================
+// Oszillator-State
+// =============================================================================
+static uint32_t phase = 0;              // Q16, 0 .. PHASE_ONE-1
+static uint32_t phaseCarry = 0;         // Divisionsrest -> keine Phasendrift
+static unsigned long lastMs = 0;
+static unsigned long beginMs = 0;
+static int startPose[SERVO_COUNT];
+
+static uint32_t dutyQ16 = 0;
+static uint32_t dutyTargetQ16 = 0;
+static uint16_t offsetQ16[LEG_COUNT];
+static uint16_t offsetTargetQ16[LEG_COUNT];
+
+static int32_t halfStrideFine = 0;      // Hip-Amplitude in 1/16 Grad
+static int32_t halfStrideTargetFine = 0;
+static int32_t liftFine = 0;            // Knee-Hub in 1/16 Grad
+static int32_t liftTargetFine = 0;
+static int32_t legScaleQ15[LEG_COUNT] = { Q15_ONE, Q15_ONE, Q15_ONE, Q15_ONE };
+static int32_t legScaleTargetQ15[LEG_COUNT] = { Q15_ONE, Q15_ONE, Q15_ONE, Q15_ONE };
+
+// Amplituden-Änderung pro Zyklus (Stride/Hub in 1/16 Grad)
+static const int32_t AMPLITUDE_SLEW_FINE = 30 * ANGLE_FINE_ONE;
+
+// IK-Modus: Fußbahnen statt Hip-Winkel (wird bei begin() übernommen)
+static bool ikActive = false;
+static int32_t halfStrideMm = 0;        // Fuß-Amplitude in 1/16 mm
+static int32_t halfStrideTargetMm = 0;
+static int32_t neutralFootX[LEG_COUNT]; // Bein-Koordinaten, 1/16 mm
+static int32_t neutralFootY[LEG_COUNT];
+static int32_t footDirQ15[LEG_COUNT][2];       // Swing-Richtung (x, y) im Bein-System
+static int32_t footDirTargetQ15[LEG_COUNT][2];
+
+// Fuß-Amplituden-Änderung pro Zyklus in 1/16 mm
+static const int32_t STRIDE_MM_SLEW_FINE = 30 * LegIK::MM_FINE_ONE;
+
+// =============================================================================
+// Helper
+// =============================================================================
+// Phasenwert auf kürzestem Weg (über den Wrap) Richtung Ziel bewegen
+static uint16_t slewPhase(uint16_t cur, uint16_t target, uint32_t step) {
+    int16_t diff = (int16_t)(target - cur);
+    if ((uint32_t)abs(diff) <= step) return target;
+    return (uint16_t)(diff > 0 ? cur + step : cur - step);
+}
+
+static int32_t slewSigned(int32_t cur, int32_t target, int32_t step) {
+    if (cur < target) return (target - cur <= step) ? target : cur + step;
+    return (cur - target <= step) ? target : cur - step;
+}
+
+static void computePoseAt(uint32_t atPhase, int pose[]) {
+    for (uint8_t leg = 0; leg < LEG_COUNT; leg++) {
+        const CpgLeg& l = LEGS[leg];
+        uint32_t psi = (atPhase + offsetQ16[leg]) & (PHASE_ONE - 1);
+
+        int32_t posQ15;     // Hip-Position -1 .. +1
+        int32_t liftQ15 = 0;
+
+        if (psi < dutyQ16) {
+            // Stance: Fuß schiebt linear von +1 nach -1
+            uint32_t u = (psi << 16) / dutyQ16;
+            posQ15 = Q15_ONE - (int32_t)u;
+        } else {
+            // Swing: Fuß schwingt von -1 nach +1, Knee hebt parabelförmig
+            uint32_t v = ((psi - dutyQ16) << 16) / (PHASE_ONE - dutyQ16);
+            int32_t vQ15 = (int32_t)(v >> 1);
+            posQ15 = -Q15_ONE + 2 * GaitRuntimeInternal::smoothstepQ15(vQ15);
+            liftQ15 = (4 * vQ15 * (Q15_ONE - vQ15)) >> 15;
+        }
+
+        int32_t hipFine;
+        int32_t kneeFine = 0;
+        if (ikActive) {
+            // Fuß auf gerader Bahn durch die Neutralposition
+            int32_t d = (halfStrideMm * posQ15) >> 15;
+            int32_t x = neutralFootX[leg] + ((d * footDirQ15[leg][0]) >> 15);
+            int32_t y = neutralFootY[leg] + ((d * footDirQ15[leg][1]) >> 15);
+            LegIK::solve(l.front, x, y, hipFine, kneeFine);
+        } else {
+            int32_t amp = (halfStrideFine * legScaleQ15[leg]) >> 15;
+            hipFine = (amp * posQ15) >> 15;
+        }
+
+        pose[l.hipIdx] = degToFine(NEUTRAL_POSE[l.hipIdx]) + l.hipSign * hipFine;
+        pose[l.kneeIdx] = degToFine(NEUTRAL_POSE[l.kneeIdx])
+            + LIFT_SIGN[l.kneeIdx] * (kneeFine + ((liftFine * liftQ15) >> 15));
+    }
+}
+
+// =============================================================================
+// API
+// =============================================================================
+void applyConfig() {
+    const CpgConfig& cfg = gaitConfig.cpg;
+
+    dutyTargetQ16 = (uint32_t)GaitRuntimeInternal::toQ16(cfg.dutyFactor);
+    for (uint8_t leg = 0; leg < LEG_COUNT; leg++) {
+        offsetTargetQ16[leg] = (uint16_t)GaitRuntimeInternal::toQ16(cfg.phaseOffset[leg]);
+    }
+
+    halfStrideTargetFine = (int32_t)(cfg.strideDeg * gaitConfig.stride.strideFactor
+                                     * (ANGLE_FINE_ONE / 2));
+    liftTargetFine = (int32_t)(cfg.stepHeight * ANGLE_FINE_ONE);
+
+    // Bein-Skalierung: Vorwärts-, Seitwärts- und Dreh-Gait bei gleicher Phase
+    // überlagert. Summe > 1 wird normiert, damit kein Bein über den Stride geht.
+    float fwd = cfg.forward;
+    float strafe = cfg.strafe;
+    float turn = cfg.turn;
+    float sum = fabsf(fwd) + fabsf(strafe) + fabsf(turn);
+    if (sum > 1.0f) {
+        fwd /= sum;
+        strafe /= sum;
+        turn /= sum;
+    }
+    for (uint8_t leg = 0; leg < LEG_COUNT; leg++) {
+        float scale = fwd + LEGS[leg].strafeSign * strafe + LEGS[leg].turnSign * turn;
+        legScaleTargetQ15[leg] = GaitRuntimeInternal::toQ16(scale) >> 1;
+    }
+
+    // IK: Fußbahnen in mm. Drehen = Tangente um die Körpermitte.
+    LegIK::applyGeometry();
+    halfStrideTargetMm = (int32_t)(cfg.strideMm * gaitConfig.stride.strideFactor
+                                   * (LegIK::MM_FINE_ONE / 2));
+    const LegGeometry& g = gaitConfig.leg;
+    for (uint8_t leg = 0; leg < LEG_COUNT; leg++) {
+        const CpgLeg& l = LEGS[leg];
+        LegIK::neutralFoot(l.front, neutralFootX[leg], neutralFootY[leg]);
+
+        // Fußposition im Körper-System (x vorwärts, y rechts)
+        float px = (l.front ? g.bodyHalfLengthMm : -g.bodyHalfLengthMm)
+                   + neutralFootX[leg] / (float)LegIK::MM_FINE_ONE;
+        float py = l.outSign * (g.bodyHalfWidthMm + neutralFootY[leg] / (float)LegIK::MM_FINE_ONE);
+        float len = sqrtf(px * px + py * py);
+        float tx = (len > 0.0f) ? -py / len : 0.0f;
+        float ty = (len > 0.0f) ? px / len : 0.0f;
+
+        float dx = fwd + turn * tx;
+        float dy = strafe + turn * ty;
+        footDirTargetQ15[leg][0] = GaitRuntimeInternal::toQ16(dx) >> 1;
+        footDirTargetQ15[leg][1] = GaitRuntimeInternal::toQ16(dy * l.outSign) >> 1;
+    }
+}
+
+void begin(unsigned long nowMs, const int fromPose[]) {
+    applyConfig();
+
+    phase = 0;
+    phaseCarry = 0;
+    lastMs = nowMs;
+    beginMs = nowMs;
+    dutyQ16 = dutyTargetQ16;
+    for (uint8_t leg = 0; leg < LEG_COUNT; leg++) {
+        offsetQ16[leg] = offsetTargetQ16[leg];
+    }
+    halfStrideFine = halfStrideTargetFine;
+    liftFine = liftTargetFine;
+    for (uint8_t leg = 0; leg < LEG_COUNT; leg++) {
+        legScaleQ15[leg] = legScaleTargetQ15[leg];
+        footDirQ15[leg][0] = footDirTargetQ15[leg][0];
+        footDirQ15[leg][1] = footDirTargetQ15[leg][1];
+    }
+    ikActive = gaitConfig.cpg.ikEnabled;
+    halfStrideMm = halfStrideTargetMm;
+    for (uint8_t i = 0; i < SERVO_COUNT; i++) {
+        startPose[i] = fromPose[i];
+    }
+}
+
+uint16_t getPeriodMs() {
+    // Gleiche Kennlinie wie die Keyframe-Timings, aber stufenlos
+    uint32_t base = gaitConfig.cpg.basePeriodMs;
+    int32_t pctX3 = 110 - speedMultiplier;      // timePercent * 3
+    uint32_t period = (pctX3 > 15) ? (base * pctX3) / 300 : (base * 5) / 100;
+    return (uint16_t)(period < 50 ? 50 : period);
+}
+
+uint16_t getPhase() {
+    return (uint16_t)phase;
+}
+
+bool advance(unsigned long nowMs) {
+    unsigned long dt = nowMs - lastMs;
+    lastMs = nowMs;
+    if (dt == 0) return false;
+    if (dt > MAX_DT_MS) dt = MAX_DT_MS;
+
+    uint32_t period = getPeriodMs();
+    uint32_t num = dt * PHASE_ONE + phaseCarry;
+    uint32_t inc = num / period;
+    phaseCarry = num % period;
+
+    // Gangart-Wechsel gleitend: max. ein voller Zyklus Übergang
+    dutyQ16 = (uint32_t)slewSigned((int32_t)dutyQ16, (int32_t)dutyTargetQ16, (int32_t)inc);
+    for (uint8_t leg = 0; leg < LEG_COUNT; leg++) {
+        offsetQ16[leg] = slewPhase(offsetQ16[leg], offsetTargetQ16[leg], inc);
+    }
+
+    // Richtungswechsel: Bein-Skalierung -1 .. +1 in einem Zyklus
+    for (uint8_t leg = 0; leg < LEG_COUNT; leg++) {
+        legScaleQ15[leg] = slewSigned(legScaleQ15[leg], legScaleTargetQ15[leg], (int32_t)inc);
+        footDirQ15[leg][0] = slewSigned(footDirQ15[leg][0], footDirTargetQ15[leg][0], (int32_t)inc);
+        footDirQ15[leg][1] = slewSigned(footDirQ15[leg][1], footDirTargetQ15[leg][1], (int32_t)inc);
+    }
+    int32_t ampStep = (int32_t)((inc * AMPLITUDE_SLEW_FINE) >> 16);
+    if (ampStep < 1) ampStep = 1;
+    halfStrideFine = slewSigned(halfStrideFine, halfStrideTargetFine, ampStep);
+    liftFine = slewSigned(liftFine, liftTargetFine, ampStep);
+    int32_t mmStep = (int32_t)((inc * STRIDE_MM_SLEW_FINE) >> 16);
+    if (mmStep < 1) mmStep = 1;
+    halfStrideMm = slewSigned(halfStrideMm, halfStrideTargetMm, mmStep);
+
+    phase += inc;
+    if (phase >= PHASE_ONE) {
+        phase &= (PHASE_ONE - 1);
+        return true;
+    }
+    return false;
+}
+
+void computePose(int pose[]) {
+    computePoseAt(phase, pose);
+
+    // Einstieg: linear aus der Startpose überblenden
+    unsigned long sinceBegin = lastMs - beginMs;
+    if (sinceBegin < ENTRY_BLEND_MS) {
+        for (uint8_t i = 0; i < SERVO_COUNT; i++) {
+            pose[i] = startPose[i]
+                + (int)(((int32_t)(pose[i] - startPose[i]) * (int32_t)sinceBegin) / ENTRY_BLEND_MS);
+        }
+    }
+}
+
+void computeRestPose(int pose[]) {
+    computePoseAt(0, pose);
+}
+
+} // namespace CpgGait
@@ -0,0 +1,46 @@
+// =============================================================================
+// CpgGait.h - Parametrischer Gait-Generator (Central Pattern Generator)
+// =============================================================================
+// v3 Gait Runtime Module für ESP8266 Spider Controller
+// Berechnet Hip/Knee-Winkel jedes Beins geschlossen aus einem Phasen-
+// Oszillator statt aus PROGMEM-Keyframes:
+//   - Duty-Faktor (Stance-Anteil) und Phasenversatz pro Bein
+//   - Schritthöhe (Knee-Hub) und Stride (Hip-Ausschlag)
+//   - Kadenz kontinuierlich aus speedMultiplier
+//   - Gangart (Creep/Trot) wechselt gleitend ohne Neustart
+//   - Optional Fußbahnen in mm über LegIK (cpg.ikEnabled)
+// Rechnet komplett in Festkomma (Phase Q16, Winkel in 1/16 Grad).
+// =============================================================================
+#ifndef CPG_GAIT_H
+#define CPG_GAIT_H
+
+#include <Arduino.h>
+#include "GaitConfig.h"
+
+namespace CpgGait {
+
+// Parameter aus gaitConfig.cpg übernehmen (nach jeder Änderung aufrufen).
+// Duty-Faktor und Phasenversatz laufen gleitend auf die neuen Werte zu.
+void applyConfig();
+
+// Oszillator starten; Übergang von startPose (1/16 Grad) in die CPG-Pose
+void begin(unsigned long nowMs, const int startPose[]);
+
+// Phase vorrücken. Rückgabe: true = Zyklusgrenze überschritten
+bool advance(unsigned long nowMs);
+
+// Aktuelle Soll-Pose für alle 8 Servos in 1/16 Grad
+void computePose(int pose[]);
+
+// Pose bei Phase 0 (Endpose beim Anhalten an der Zyklusgrenze)
+void computeRestPose(int pose[]);
+
+// Aktuelle Zyklusdauer in ms (aus basePeriodMs und speedMultiplier)
+uint16_t getPeriodMs();
+
+// Aktuelle Phase (0 - 65535 = ein Zyklus)
+uint16_t getPhase();
+
+} // namespace CpgGait
+
+#endif // CPG_GAIT_H
@@ -0,0 +1,128 @@
+// =============================================================================
+// Easing.cpp - Implementierung der Easing-Tabellen
+// =============================================================================
+#include "Easing.h"
+
+namespace Easing {
+
+// =============================================================================
+// Lookup-Tabellen: f(i/64) für i = 0..64 in Q15
+// =============================================================================
+// Smoothstep 3t² - 2t³
+static const uint16_t SMOOTHSTEP_LUT[EASING_LUT_SIZE + 1] PROGMEM = {
+        0,    24,    94,   209,   368,   569,   810,  1090,  1408,  1762,
+     2150,  2571,  3024,  3507,  4018,  4556,  5120,  5708,  6318,  6949,
+     7600,  8269,  8954,  9654, 10368, 11094, 11830, 12575, 13328, 14087,
+    14850, 15616, 16384, 17152, 17918, 18681, 19440, 20193, 20938, 21674,
+    22400, 23114, 23814, 24499, 25168, 25819, 26450, 27060, 27648, 28212,
+    28750, 29261, 29744, 30197, 30618, 31006, 31360, 31678, 31958, 32199,
+    32400, 32559, 32674, 32744, 32768,
+};
+
+// Smootherstep 6t⁵ - 15t⁴ + 10t³
+static const uint16_t SMOOTHERSTEP_LUT[EASING_LUT_SIZE + 1] PROGMEM = {
+        0,     1,    10,    31,    73,   139,   233,   361,   526,   730,
+      975,  1264,  1598,  1977,  2403,  2875,  3392,  3954,  4561,  5209,
+     5898,  6626,  7391,  8189,  9018,  9875, 10758, 11662, 12584, 13521,
+    14469, 15425, 16384, 17343, 18299, 19247, 20184, 21106, 22010, 22893,
+    23750, 24579, 25377, 26142, 26870, 27559, 28207, 28814, 29376, 29893,
+    30365, 30791, 31170, 31504, 31793, 32038, 32242, 32407, 32535, 32629,
+    32695, 32737, 32758, 32767, 32768,
+};
+
+// Cubic In/Out: 4t³ bis zur Mitte, dann gespiegelt
+static const uint16_t CUBIC_IN_OUT_LUT[EASING_LUT_SIZE + 1] PROGMEM = {
+        0,     0,     4,    14,    32,    62,   108,   172,   256,   364,
+      500,   666,   864,  1098,  1372,  1688,  2048,  2456,  2916,  3430,
+     4000,  4630,  5324,  6084,  6912,  7812,  8788,  9842, 10976, 12194,
+    13500, 14896, 16384, 17872, 19268, 20574, 21792, 22926, 23980, 24956,
+    25856, 26684, 27444, 28138, 28768, 29338, 29852, 30312, 30720, 31080,
+    31396, 31670, 31904, 32102, 32268, 32404, 32512, 32596, 32660, 32706,
+    32736, 32754, 32764, 32768, 32768,
+};
+
+// Benutzerkurve (RAM), aus gaitConfig.easing.custom
+static uint16_t customLut[EASING_LUT_SIZE + 1];
+
+static const uint16_t* tableFor(EasingCurve curve) {
+    switch (curve) {
+        case EasingCurve::SMOOTHSTEP:   return SMOOTHSTEP_LUT;
+        case EasingCurve::SMOOTHERSTEP: return SMOOTHERSTEP_LUT;
+        case EasingCurve::CUBIC_IN_OUT: return CUBIC_IN_OUT_LUT;
+        default:                        return nullptr;
+    }
+}
+
+// =============================================================================
+// API
+// =============================================================================
+void applyConfig() {
+    const uint8_t* points = gaitConfig.easing.custom;
+    const uint16_t perInterval = EASING_LUT_SIZE / (EASING_CUSTOM_POINTS - 1);
+    
+    // Stützstellen (Prozent) linear auf die 65 Tabelleneinträge verteilen
+    for (uint16_t i = 0; i <= EASING_LUT_SIZE; i++) {
+        uint8_t seg = i / perInterval;
+        if (seg >= EASING_CUSTOM_POINTS - 1) seg = EASING_CUSTOM_POINTS - 2;
+        int32_t frac = i - seg * perInterval;
+        int32_t a = points[seg];
+        int32_t b = points[seg + 1];
+        int32_t percentScaled = a * perInterval + (b - a) * frac;
+        customLut[i] = (uint16_t)((percentScaled * Q15_ONE) / (100 * perInterval));
+    }
+}
+
+int32_t evalQ15(EasingCurve curve, int32_t alphaQ15) {
+    if (alphaQ15 <= 0) return 0;
+    if (alphaQ15 >= Q15_ONE) return Q15_ONE;
+    
+    const int shift = 15 - EASING_LUT_SHIFT;
+    int32_t idx = alphaQ15 >> shift;
+    int32_t frac = alphaQ15 & ((1 << shift) - 1);
+    
+    int32_t a, b;
+    if (curve == EasingCurve::CUSTOM) {
+        a = customLut[idx];
+        b = customLut[idx + 1];
+    } else {
+        const uint16_t* table = tableFor(curve);
+        if (!table) return alphaQ15;
+        a = pgm_read_word(&table[idx]);
+        b = pgm_read_word(&table[idx + 1]);
+    }
+    return a + (((b - a) * frac) >> shift);
+}
+
+float evalFloat(EasingCurve curve, float alpha) {
+    if (alpha <= 0.0f) return 0.0f;
+    if (alpha >= 1.0f) return 1.0f;
+    
+    switch (curve) {
+        case EasingCurve::SMOOTHSTEP:
+            return alpha * alpha * (3.0f - 2.0f * alpha);
+        case EasingCurve::SMOOTHERSTEP:
+            return alpha * alpha * alpha * (alpha * (alpha * 6.0f - 15.0f) + 10.0f);
+        case EasingCurve::CUBIC_IN_OUT: {
+            if (alpha < 0.5f) return 4.0f * alpha * alpha * alpha;
+            float u = 1.0f - alpha;
+            return 1.0f - 4.0f * u * u * u;
+        }
+        case EasingCurve::CUSTOM: {
+            const uint8_t* points = gaitConfig.easing.custom;
+            float pos = alpha * (EASING_CUSTOM_POINTS - 1);
+            uint8_t seg = (uint8_t)pos;
+            if (seg >= EASING_CUSTOM_POINTS - 1) seg = EASING_CUSTOM_POINTS - 2;
+            float frac = pos - seg;
+            return (points[seg] + (points[seg + 1] - points[seg]) * frac) / 100.0f;
+        }
+        default:
+            return alpha;
+    }
+}
+
+EasingCurve curveFor(TimingProfile profile, uint8_t servo) {
+    uint8_t p = (uint8_t)profile < TIMING_PROFILE_COUNT ? (uint8_t)profile : 0;
+    return isHipServo(servo) ? gaitConfig.easing.hip[p] : gaitConfig.easing.knee[p];
+}
+
+} // namespace Easing
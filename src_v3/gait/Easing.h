@@ -0,0 +1,40 @@
+// =============================================================================
+// Easing.h - Easing-Kurven als Lookup-Tabellen
+// =============================================================================
+// v3 Gait Runtime Module für ESP8266 Spider Controller
+// Jede Kurve liegt als Tabelle mit 65 Stützstellen (Q15) vor, ausgewertet wird
+// mit einem Lookup und linearer Interpolation zwischen zwei Einträgen.
+// Eingebaute Kurven in PROGMEM, die Benutzerkurve (gaitConfig.easing.custom)
+// wird bei applyConfig() in eine RAM-Tabelle umgerechnet.
+// Die Kurve je Servo kommt aus gaitConfig.easing[Timing-Profil][Hip/Knee].
+// Der Float-Pfad (GAIT_FIXED_POINT 0, benchmark()) rechnet ohne Tabellen
+// (evalFloat), der Vergleich misst damit auch den Tabellenfehler.
+// =============================================================================
+#ifndef EASING_H
+#define EASING_H
+
+#include <Arduino.h>
+#include "GaitConfig.h"
+
+namespace Easing {
+
+// 64 Intervalle, Index = alphaQ15 >> 9
+static const uint8_t EASING_LUT_SHIFT = 6;
+static const uint16_t EASING_LUT_SIZE = 1 << EASING_LUT_SHIFT;
+
+// Benutzerkurve aus gaitConfig.easing neu aufbauen (nach jeder Änderung aufrufen)
+void applyConfig();
+
+// Kurve an alphaQ15 (0 .. Q15_ONE) auswerten, Ergebnis in Q15
+int32_t evalQ15(EasingCurve curve, int32_t alphaQ15);
+
+// Referenz ohne Tabellen für den Float-Pfad: geschlossene Formeln bzw.
+// lineare Interpolation der Stützstellen der Benutzerkurve (alpha 0..1)
+float evalFloat(EasingCurve curve, float alpha);
+
+// Kurve für servo im Timing-Profil profile (Hip- oder Knee-Rolle)
+EasingCurve curveFor(TimingProfile profile, uint8_t servo);
+
+} // namespace Easing
+
+#endif // EASING_H
@@ -9,11 +9,75 @@
 
 #include <Arduino.h>
 
+// =============================================================================
+// Fixed-Point Interpolation (ESP8266 hat keine FPU)
+// =============================================================================
+// 1 = Easing, Stride-Skalierung, Interpolation und Timing in Q15/Q16 rechnen
+// 0 = Float-Referenzpfad
+#ifndef GAIT_FIXED_POINT
+#define GAIT_FIXED_POINT 0
+#endif
+
+// Q-Formate: Q15 für Werte in [0, 1], Q16 für Faktoren (Stride, Multiplier)
+static const int32_t Q15_ONE = 1L << 15;
+static const int32_t Q16_ONE = 1L << 16;
+
 // =============================================================================
 // Servo-Konfiguration
 // =============================================================================
 static const uint8_t SERVO_COUNT = 8;
 
+// Maximale Anzahl vorberechneter Waypoints pro Keyframe-Segment
+static const uint8_t MAX_SUB_STEPS = 16;
+
+// Keyframe-Zeitbasis: minimale reale Segmentdauer und max. Zeitschritt pro Tick
+static const int32_t SEGMENT_MIN_MS = 20;
+static const unsigned long PHASE_MAX_DT_US = 1000000;
+
+// Segment-Cache: Gangarten (Tabellen) und Keyframes pro Gangart
+static const uint8_t SEGMENT_CACHE_SLOTS = 2;
+static const uint8_t SEGMENT_CACHE_STEPS = 12;
+
+// =============================================================================
+// Sub-Grad-Auflösung und Pulsbreiten
+// =============================================================================
+// Die Gait-Engine rechnet intern in 1/16 Grad ("fine"), die Ausgabe erfolgt
+// per writeMicroseconds() auf 400-2400 µs (≈ 0.7 µs pro fine-Einheit).
+static const uint8_t ANGLE_FINE_SHIFT = 4;
+static const int ANGLE_FINE_ONE = 1 << ANGLE_FINE_SHIFT;
+static const int SERVO_PULSE_MIN_US = 400;
+static const int SERVO_PULSE_MAX_US = 2400;
+
+// =============================================================================
+// Servo-Ausgabe (siehe motion/ServoOutput.h)
+// =============================================================================
+// 1 = Pulse aus der Timer1-ISR, Übernahme an der Frame-Grenze
+// 0 = Servo-Library, jeder Schreibzugriff geht sofort raus
+#ifndef SERVO_FRAME_ISR
+#define SERVO_FRAME_ISR 1
+#endif
+
+static const uint32_t SERVO_FRAME_US = 20000;
+
+inline int degToFine(int deg) {
+    return deg * ANGLE_FINE_ONE;
+}
+
+inline int fineToDeg(int fine) {
+    return (fine + ANGLE_FINE_ONE / 2) >> ANGLE_FINE_SHIFT;  // Runden
+}
+
+inline int fineToUs(int fine) {
+    const int span = 180 * ANGLE_FINE_ONE;
+    return SERVO_PULSE_MIN_US
+        + (fine * (SERVO_PULSE_MAX_US - SERVO_PULSE_MIN_US) + span / 2) / span;
+}
+
+inline int usToFine(int us) {
+    const int range = SERVO_PULSE_MAX_US - SERVO_PULSE_MIN_US;
+    return ((us - SERVO_PULSE_MIN_US) * 180 * ANGLE_FINE_ONE + range / 2) / range;
+}
+
 // Servo-Typ-Indizes (aus Codebase-Analyse bestätigt)
 // Hip (Arm) Servos: stärkere Stride-Skalierung
 static const uint8_t HIP_SERVO_IDX[] = { 1, 2, 5, 6 };
@@ -23,6 +87,14 @@ static const uint8_t HIP_COUNT = 4;
 static const uint8_t KNEE_SERVO_IDX[] = { 0, 3, 4, 7 };
 static const uint8_t KNEE_COUNT = 4;
 
+// Bein je Servo (Reihenfolge wie HIP_SERVO_IDX/KNEE_SERVO_IDX: UR, LR, UL, LL)
+static const uint8_t LEG_COUNT = 4;
+static const uint8_t SERVO_LEG[SERVO_COUNT] = { 0, 0, 1, 1, 2, 2, 3, 3 };
+
+inline bool isHipServo(uint8_t servo) {
+    return servo < SERVO_COUNT && HIP_SERVO_IDX[SERVO_LEG[servo]] == servo;
+}
+
 // Lift-Sign für Swing/Stance Erkennung (aus MotionData.cpp)
 // +1 = positiver Delta = Bein hebt, -1 = negativer Delta = Bein hebt
 static const int8_t LIFT_SIGN[SERVO_COUNT] = { -1, 0, 0, -1, +1, 0, 0, +1 };
@@ -62,56 +134,321 @@ struct TimingConfig {
         , liftThreshold(8) {}
 };
 
+// =============================================================================
+// Easing-Kurven pro Timing-Profil und Servo-Rolle (siehe Easing.h)
+// =============================================================================
+enum class EasingCurve : uint8_t {
+    LINEAR = 0,
+    SMOOTHSTEP = 1,    // 3t² - 2t³
+    SMOOTHERSTEP = 2,  // 6t⁵ - 15t⁴ + 10t³ (auch Beschleunigung stetig)
+    CUBIC_IN_OUT = 3,  // 4t³ / gespiegelt, stärkeres Anfahren und Abbremsen
+    CUSTOM = 4         // Benutzerkurve aus EasingConfig::custom
+};
+
+static const uint8_t TIMING_PROFILE_COUNT = 3;
+static const uint8_t EASING_CUSTOM_POINTS = 9;   // Stützstellen bei 0, 1/8, ..., 1
+
+struct EasingConfig {
+    EasingCurve hip[TIMING_PROFILE_COUNT];    // Index = TimingProfile
+    EasingCurve knee[TIMING_PROFILE_COUNT];
+    uint8_t custom[EASING_CUSTOM_POINTS];     // Benutzerkurve in Prozent (0-100)
+    
+    // Linear/SwingStance wie bisher Smoothstep, EaseInOut weicher an den Keyframes
+    EasingConfig() {
+        for (uint8_t p = 0; p < TIMING_PROFILE_COUNT; p++) {
+            hip[p] = EasingCurve::SMOOTHSTEP;
+            knee[p] = EasingCurve::SMOOTHSTEP;
+        }
+        hip[(uint8_t)TimingProfile::EASE_IN_OUT] = EasingCurve::SMOOTHERSTEP;
+        knee[(uint8_t)TimingProfile::EASE_IN_OUT] = EasingCurve::CUBIC_IN_OUT;
+        
+        static const uint8_t DEFAULT_CUSTOM[EASING_CUSTOM_POINTS] = { 0, 4, 16, 34, 50, 66, 84, 96, 100 };
+        for (uint8_t i = 0; i < EASING_CUSTOM_POINTS; i++) {
+            custom[i] = DEFAULT_CUSTOM[i];
+        }
+    }
+    
+    void validate() {
+        for (uint8_t p = 0; p < TIMING_PROFILE_COUNT; p++) {
+            if ((uint8_t)hip[p] > (uint8_t)EasingCurve::CUSTOM) hip[p] = EasingCurve::SMOOTHSTEP;
+            if ((uint8_t)knee[p] > (uint8_t)EasingCurve::CUSTOM) knee[p] = EasingCurve::SMOOTHSTEP;
+        }
+        for (uint8_t i = 0; i < EASING_CUSTOM_POINTS; i++) {
+            if (custom[i] > 100) custom[i] = 100;
+        }
+        custom[0] = 0;
+        custom[EASING_CUSTOM_POINTS - 1] = 100;
+    }
+};
+
 // =============================================================================
 // Interpolation / Micro-Stepping Konfiguration
 // =============================================================================
+// Werte 0/1 entsprechen dem früheren bool smoothstepEnabled (Config-Datei kompatibel)
+enum class InterpolationMode : uint8_t {
+    LINEAR = 0,        // Linear pro Segment
+    SMOOTHSTEP = 1,    // Easing-Kurve pro Segment nach Profil/Rolle (Stopp an jedem Keyframe)
+    SPLINE = 2         // Kubische Hermite-Spline über Nachbar-Keyframes (C1)
+};
+
 struct InterpolationConfig {
-    uint8_t subSteps;        // Substeps pro Keyframe-Übergang (1-16)
-    bool smoothstepEnabled;  // Smoothstep Easing aktiviert
+    uint8_t subSteps;        // Waypoints pro Keyframe-Übergang (1-MAX_SUB_STEPS)
+    InterpolationMode mode;  // Interpolation zwischen Keyframes
     
     // Defaults aus User-Anforderung
-    InterpolationConfig() : subSteps(8), smoothstepEnabled(true) {}
+    InterpolationConfig() : subSteps(8), mode(InterpolationMode::SMOOTHSTEP) {}
 };
 
 // =============================================================================
 // Soft-Start/Stop Ramp Konfiguration
 // =============================================================================
+// Stride, bei dem Soft-Start beginnt und Soft-Stop endet
+static const float STRIDE_RAMP_MIN = 0.3f;
+// Max. Stride-Änderung pro Segment bei Änderungen während des Laufens
+static const float STRIDE_SLEW_PER_SEGMENT = 0.05f;
+static const uint8_t RAMP_DEFAULT_STOP_SEGMENTS = 4;
+
 struct RampConfig {
-    bool enabled;
-    uint8_t rampCycles;      // Anzahl Zyklen für Ramp (0 = instant)
-    float currentStride;     // Aktueller interpolierter Stride
+    bool enabled;            // Soft-Start/-Stop
+    uint8_t rampCycles;      // Anzahl Zyklen für Soft-Start (0 = instant)
+    uint8_t stopSegments;    // Segmente für Soft-Stop (1-30)
+    float currentStride;     // Aktueller Stride (pro Segment nachgeführt)
     float targetStride;      // Ziel-Stride
     
-    RampConfig() : enabled(false), rampCycles(3), currentStride(1.0f), targetStride(1.0f) {}
+    RampConfig() : enabled(false), rampCycles(3), stopSegments(RAMP_DEFAULT_STOP_SEGMENTS),
+                   currentStride(1.0f), targetStride(1.0f) {}
+};
+
+// =============================================================================
+// CPG-Gait (Phasen-Oszillator statt Keyframe-Tabelle)
+// =============================================================================
+// Bein-Reihenfolge für phaseOffset[]: UR, LR, UL, LL
+
+enum class CpgGaitType : uint8_t {
+    CREEP = 0,   // Immer nur ein Bein in der Luft (Duty 0.75)
+    TROT = 1     // Diagonale Beinpaare gleichzeitig (Duty 0.5)
+};
+
+struct CpgConfig {
+    float dutyFactor;          // Anteil Stance am Zyklus (0.5 - 0.9)
+    float phaseOffset[LEG_COUNT]; // Phasenversatz pro Bein (0.0 - 1.0)
+    float stepHeight;          // Knee-Hub in der Swing-Phase (Grad)
+    float strideDeg;           // Hip-Ausschlag Spitze-Spitze (Grad, x strideFactor)
+    uint16_t basePeriodMs;     // Zyklusdauer bei timePercent = 100%
+    bool ikEnabled;            // Fußbahnen über LegIK statt Hip-Winkel
+    float strideMm;            // Schrittlänge mit IK (mm, x strideFactor)
+    float forward;             // Vorwärts-Anteil (-1.0 - 1.0)
+    float strafe;              // Seitwärts-Anteil (-1.0 = links, 1.0 = rechts)
+    float turn;                // Dreh-Anteil (-1.0 = links, 1.0 = rechts)
+    
+    CpgConfig()
+        : dutyFactor(0.75f)
+        , stepHeight(12.0f)
+        , strideDeg(30.0f)
+        , basePeriodMs(1860)   // = Summe der Keyframe-Zeiten von Servo_Prg_2
+        , ikEnabled(false)
+        , strideMm(30.0f)
+        , forward(1.0f)
+        , strafe(0.0f)
+        , turn(0.0f) {
+        setGaitType(CpgGaitType::CREEP);
+    }
+    
+    void setGaitType(CpgGaitType type) {
+        if (type == CpgGaitType::TROT) {
+            dutyFactor = 0.5f;
+            phaseOffset[0] = 0.0f;    // UR
+            phaseOffset[1] = 0.5f;    // LR
+            phaseOffset[2] = 0.5f;    // UL
+            phaseOffset[3] = 0.0f;    // LL
+        } else {
+            dutyFactor = 0.75f;
+            phaseOffset[0] = 0.0f;    // UR
+            phaseOffset[1] = 0.75f;   // LR
+            phaseOffset[2] = 0.5f;    // UL
+            phaseOffset[3] = 0.25f;   // LL
+        }
+    }
+    
+    void validate() {
+        if (dutyFactor < 0.5f) dutyFactor = 0.5f;
+        if (dutyFactor > 0.9f) dutyFactor = 0.9f;
+        for (uint8_t i = 0; i < LEG_COUNT; i++) {
+            if (phaseOffset[i] < 0.0f) phaseOffset[i] = 0.0f;
+            if (phaseOffset[i] >= 1.0f) phaseOffset[i] = 0.0f;
+        }
+        if (stepHeight < 0.0f) stepHeight = 0.0f;
+        if (stepHeight > 40.0f) stepHeight = 40.0f;
+        if (strideDeg < 0.0f) strideDeg = 0.0f;
+        if (strideDeg > 60.0f) strideDeg = 60.0f;
+        if (basePeriodMs < 300) basePeriodMs = 300;
+        if (basePeriodMs > 6000) basePeriodMs = 6000;
+        if (strideMm < 0.0f) strideMm = 0.0f;
+        if (strideMm > 80.0f) strideMm = 80.0f;
+        if (forward < -1.0f) forward = -1.0f;
+        if (forward > 1.0f) forward = 1.0f;
+        if (strafe < -1.0f) strafe = -1.0f;
+        if (strafe > 1.0f) strafe = 1.0f;
+        if (turn < -1.0f) turn = -1.0f;
+        if (turn > 1.0f) turn = 1.0f;
+    }
+};
+
+// =============================================================================
+// Bein-Geometrie für LegIK (2-DOF: Hip dreht horizontal, Knee neigt Unterschenkel)
+// =============================================================================
+struct LegGeometry {
+    float coxaMm;              // Hip-Achse bis Knee-Achse
+    float tibiaMm;             // Knee-Achse bis Fußspitze
+    float neutralTiltDeg;      // Unterschenkel-Neigung unter der Horizontalen in Neutralpose
+    float mountDeg;            // Bein-Richtung in Neutralpose, von quer zur Längsachse
+    float bodyHalfLengthMm;    // Hip-Achse zur Körpermitte, längs
+    float bodyHalfWidthMm;     // Hip-Achse zur Körpermitte, quer
+    
+    LegGeometry()
+        : coxaMm(27.0f)
+        , tibiaMm(45.0f)
+        , neutralTiltDeg(60.0f)
+        , mountDeg(45.0f)
+        , bodyHalfLengthMm(32.0f)
+        , bodyHalfWidthMm(32.0f) {}
+    
+    void validate() {
+        if (coxaMm < 5.0f) coxaMm = 5.0f;
+        if (coxaMm > 150.0f) coxaMm = 150.0f;
+        if (tibiaMm < 10.0f) tibiaMm = 10.0f;
+        if (tibiaMm > 150.0f) tibiaMm = 150.0f;
+        if (neutralTiltDeg < 10.0f) neutralTiltDeg = 10.0f;
+        if (neutralTiltDeg > 85.0f) neutralTiltDeg = 85.0f;
+        if (mountDeg < 0.0f) mountDeg = 0.0f;
+        if (mountDeg > 80.0f) mountDeg = 80.0f;
+        if (bodyHalfLengthMm < 0.0f) bodyHalfLengthMm = 0.0f;
+        if (bodyHalfWidthMm < 0.0f) bodyHalfWidthMm = 0.0f;
+    }
 };
 
 // =============================================================================
 // Servo-Limits pro Servo (kalibrierbar)
 // =============================================================================
+// Default-Limits, gegen die auch die eingebauten Keyframe-Tabellen beim
+// Kompilieren geprüft werden (siehe Keyframe.h)
+static const int SERVO_DEFAULT_MIN_ANGLE = 20;
+static const int SERVO_DEFAULT_MAX_ANGLE = 160;
+static const int SERVO_DEFAULT_CENTER_ANGLE = 90;
+
 struct ServoLimits {
     int minAngle;            // Minimaler sicherer Winkel
     int maxAngle;            // Maximaler sicherer Winkel
     int centerAngle;         // Neutralpunkt für Stride-Skalierung
     
-    ServoLimits() : minAngle(20), maxAngle(160), centerAngle(90) {}
+    ServoLimits()
+        : minAngle(SERVO_DEFAULT_MIN_ANGLE)
+        , maxAngle(SERVO_DEFAULT_MAX_ANGLE)
+        , centerAngle(SERVO_DEFAULT_CENTER_ANGLE) {}
     ServoLimits(int min, int max, int center) : minAngle(min), maxAngle(max), centerAngle(center) {}
 };
 
+// =============================================================================
+// Slew-Limiter am Servo-Ausgang (Geschwindigkeit/Beschleunigung pro Servo)
+// =============================================================================
+static const uint16_t SLEW_DEFAULT_VELOCITY = 500;     // Grad/s (SG90 ohne Last ca. 600)
+static const uint16_t SLEW_DEFAULT_ACCEL = 20000;      // Grad/s²
+
+struct SlewConfig {
+    bool enabled;
+    uint16_t maxVelocity[SERVO_COUNT];   // Grad/s
+    uint16_t maxAccel[SERVO_COUNT];      // Grad/s²
+    
+    SlewConfig() : enabled(true) {
+        for (uint8_t i = 0; i < SERVO_COUNT; i++) {
+            maxVelocity[i] = SLEW_DEFAULT_VELOCITY;
+            maxAccel[i] = SLEW_DEFAULT_ACCEL;
+        }
+    }
+    
+    void validate() {
+        for (uint8_t i = 0; i < SERVO_COUNT; i++) {
+            if (maxVelocity[i] < 30) maxVelocity[i] = 30;
+            if (maxVelocity[i] > 2000) maxVelocity[i] = 2000;
+            if (maxAccel[i] < 100) maxAccel[i] = 100;
+            if (maxAccel[i] > 50000) maxAccel[i] = 50000;
+        }
+    }
+};
+
+// =============================================================================
+// PWM-Ausgabe: versetzte Pulsstarts (nur mit SERVO_FRAME_ISR)
+// =============================================================================
+// Kanal k startet seinen Puls staggerUs * k nach der Frame-Grenze.
+// Bei 2500 µs (= 20 ms / 8) überlappen sich keine zwei Pulse.
+static const uint16_t PWM_STAGGER_MAX_US = SERVO_FRAME_US / SERVO_COUNT;
+
+struct PwmConfig {
+    uint16_t staggerUs;
+    
+    PwmConfig() : staggerUs(PWM_STAGGER_MAX_US) {}
+    
+    void validate() {
+        if (staggerUs > PWM_STAGGER_MAX_US) staggerUs = PWM_STAGGER_MAX_US;
+    }
+};
+
+// =============================================================================
+// Strombudget: geschätzter Servo-Strom und Verteilung der Bewegungen
+// =============================================================================
+// Modell: Strom proportional zur kommandierten Winkelgeschwindigkeit,
+// gewichtet nach Rolle (mA bei 100 Grad/s). Überschreitet ein Segment das
+// Budget, startet ein Bein mit Spielraum später, reicht das nicht, wird das
+// Segment gestreckt.
+static const uint16_t CURRENT_DEFAULT_BUDGET_MA = 3000;
+static const uint16_t CURRENT_DEFAULT_HIP_MA = 100;     // mA bei 100 Grad/s
+static const uint16_t CURRENT_DEFAULT_KNEE_MA = 70;
+static const uint16_t CURRENT_MAX_STRETCH_PCT = 200;    // Segment höchstens auf das Doppelte strecken
+static const uint16_t SERVO_UNLIMITED_DPS = 600;        // Servo ohne Slew-Limiter (SG90 ohne Last)
+
+struct CurrentConfig {
+    bool enabled;
+    uint16_t budgetMa;
+    uint16_t hipMaPer100Dps;
+    uint16_t kneeMaPer100Dps;
+    
+    CurrentConfig()
+        : enabled(true)
+        , budgetMa(CURRENT_DEFAULT_BUDGET_MA)
+        , hipMaPer100Dps(CURRENT_DEFAULT_HIP_MA)
+        , kneeMaPer100Dps(CURRENT_DEFAULT_KNEE_MA) {}
+    
+    void validate() {
+        if (budgetMa < 200) budgetMa = 200;
+        if (budgetMa > 10000) budgetMa = 10000;
+        if (hipMaPer100Dps < 1) hipMaPer100Dps = 1;
+        if (hipMaPer100Dps > 1000) hipMaPer100Dps = 1000;
+        if (kneeMaPer100Dps < 1) kneeMaPer100Dps = 1;
+        if (kneeMaPer100Dps > 1000) kneeMaPer100Dps = 1000;
+    }
+};
+
 // =============================================================================
 // Gesamte Gait-Runtime Konfiguration
 // =============================================================================
 struct GaitRuntimeConfig {
     StrideConfig stride;
     TimingConfig timing;
+    EasingConfig easing;
     InterpolationConfig interpolation;
     RampConfig ramp;
+    CpgConfig cpg;
+    LegGeometry leg;
+    SlewConfig slew;
+    PwmConfig pwm;
+    CurrentConfig current;
     ServoLimits servoLimits[SERVO_COUNT];
     
     // Initialisierung mit Standard-Werten
     GaitRuntimeConfig() {
         // Standard-Limits für alle Servos (konservativ)
         for (uint8_t i = 0; i < SERVO_COUNT; i++) {
-            servoLimits[i] = ServoLimits(20, 160, 90);
+            servoLimits[i] = ServoLimits();
         }
     }
     
@@ -127,16 +464,29 @@ struct GaitRuntimeConfig {
         
         // SubSteps begrenzen
         if (interpolation.subSteps < 1) interpolation.subSteps = 1;
-        if (interpolation.subSteps > 16) interpolation.subSteps = 16;
+        if (interpolation.subSteps > MAX_SUB_STEPS) interpolation.subSteps = MAX_SUB_STEPS;
+        if ((uint8_t)interpolation.mode > (uint8_t)InterpolationMode::SPLINE) {
+            interpolation.mode = InterpolationMode::SMOOTHSTEP;
+        }
         
         // Timing-Multiplier begrenzen
         if (timing.swingMultiplier < 0.3f) timing.swingMultiplier = 0.3f;
         if (timing.swingMultiplier > 2.0f) timing.swingMultiplier = 2.0f;
         if (timing.stanceMultiplier < 0.3f) timing.stanceMultiplier = 0.3f;
         if (timing.stanceMultiplier > 2.0f) timing.stanceMultiplier = 2.0f;
+        if ((uint8_t)timing.profile >= TIMING_PROFILE_COUNT) timing.profile = TimingProfile::SWING_STANCE;
+        easing.validate();
         
         // Ramp-Cycles begrenzen
         if (ramp.rampCycles > 10) ramp.rampCycles = 10;
+        if (ramp.stopSegments < 1) ramp.stopSegments = 1;
+        if (ramp.stopSegments > 30) ramp.stopSegments = 30;
+        
+        cpg.validate();
+        leg.validate();
+        slew.validate();
+        pwm.validate();
+        current.validate();
     }
 };
 
@@ -145,4 +495,17 @@ struct GaitRuntimeConfig {
 // =============================================================================
 extern GaitRuntimeConfig gaitConfig;
 
+// Geschätzter Strom (mA), wenn servo deltaFine (1/16 Grad) in durationUs fährt
+inline uint32_t estimateCurrentMa(uint8_t servo, uint32_t deltaFine, uint32_t durationUs) {
+    if (durationUs == 0) durationUs = 1;
+    uint32_t weight = isHipServo(servo) ? gaitConfig.current.hipMaPer100Dps
+                                        : gaitConfig.current.kneeMaPer100Dps;
+    // Schneller als SERVO_UNLIMITED_DPS fährt der Servo nicht, kürzere
+    // Intervalle erhöhen den Strom daher nicht weiter
+    uint32_t minUs = (uint32_t)((uint64_t)deltaFine * 1000000 / (SERVO_UNLIMITED_DPS * 16));
+    if (durationUs < minUs) durationUs = minUs;
+    // 100 Grad/s = 1600 fine pro 10^6 µs -> weight * delta * 10^6 / (1600 * t)
+    return (uint32_t)((uint64_t)weight * deltaFine * 625 / durationUs);
+}
+
 #endif // GAIT_CONFIG_H
@@ -2,6 +2,8 @@
 // GaitRuntime.cpp - Implementierung der erweiterten Motion Engine
 // =============================================================================
 #include "GaitRuntime.h"
+#include "CpgGait.h"
+#include "Easing.h"
 #include <LittleFS.h>
 
 // =============================================================================
@@ -10,11 +12,68 @@
 GaitRuntimeConfig gaitConfig;
 static GaitMotionState gaitState;
 
+// Q16-Kopien der Float-Parameter, bei Änderung einmal umgerechnet
+struct FixedPointParams {
+    int32_t strideQ16;       // ramp.currentStride
+    int32_t kneeMixQ16;
+    int32_t swingMulQ16;
+    int32_t stanceMulQ16;
+};
+static FixedPointParams fixedParams;
+
+// Zuletzt von der Engine gesetzte Pose in 1/16 Grad (Running_Servo_POS ist ganzzahlig)
+static int currentPoseFine[SERVO_COUNT];
+
+// =============================================================================
+// Segment-Cache
+// =============================================================================
+// Geplante Segmente (skalierte Zielpose, Phasen, Dauer) pro Gangart. Im
+// Dauerlauf beginnt jedes Segment an der Zielpose des vorherigen, ab dem
+// zweiten Zyklus ist jeder Keyframe ein Treffer und planSegment() kopiert nur.
+// Die Startpose ist Teil des Schlüssels, der Start aus dem Stand wird deshalb
+// normal geplant. Ebenso der Stride: Ramp und Slew ändern ihn pro Segment,
+// ein anderer Stride ist nur ein Fehlschlag für diesen Eintrag. Setter für
+// Knee-Mix, Timing und Limits verwerfen den Cache (invalidateSegmentCache).
+struct CachedSegment {
+    bool valid;
+    bool inLimits;
+    int32_t strideQ16;                 // Schlüssel
+    int16_t fromPose[SERVO_COUNT];     // Schlüssel
+    int16_t scaledToPose[SERVO_COUNT];
+    uint8_t toPose[SERVO_COUNT];       // Keyframe-Rohwerte in Grad
+    uint16_t segmentDuration;
+    uint16_t adjustedDuration;
+    GaitPhase phase;
+    GaitPhase legPhase[LEG_COUNT];
+    uint16_t legFinishQ15[LEG_COUNT];
+};
+
+struct SegmentCacheSlot {
+    const Keyframe* keyframes;         // Tabelle der Gangart (nullptr = frei)
+    uint8_t transform;
+    uint32_t lastUse;
+    CachedSegment entries[SEGMENT_CACHE_STEPS];
+};
+
+static SegmentCacheSlot segmentCache[SEGMENT_CACHE_SLOTS];
+static SegmentCacheSlot* activeCacheSlot = nullptr;   // nullptr = laufende Bewegung nicht gecacht
+static uint32_t segmentCacheUse = 0;
+static GaitRuntime::SegmentCacheStats segmentCacheStats = GaitRuntime::SegmentCacheStats();
+
+// Strombudget: Statistik und Summen des laufenden Zyklus
+static GaitRuntime::CurrentStats currentStats = GaitRuntime::CurrentStats();
+static uint16_t cyclePeakMa = 0;
+static uint64_t cycleChargeMaUs = 0;     // Summe mittlerer Strom * Dauer
+static uint32_t cycleDurationUs = 0;
+
+// CPG: Ausgabe-Intervall (Servo-Frame ist 20 ms, öfter schreiben bringt nichts)
+static const unsigned long CPG_OUTPUT_INTERVAL_MS = 10;
+
 // Externe Abhängigkeiten (aus MotionData)
 extern int Running_Servo_POS[];
 extern int speedMultiplier;
 extern int Servo_Offset[];
-extern void Set_PWM_to_Servo(int iServo, int iValue);
+extern void Set_PWM_to_Servo_Fine(int iServo, int fineAngle);
 extern void terrain_blend_tick();
 extern int getTerrainAdjustment(int iServo);
 
@@ -30,27 +89,39 @@ float smoothstep(float t) {
     return t * t * (3.0f - 2.0f * t);
 }
 
-// Phase-Erkennung basierend auf Knee/Paw-Servo-Deltas
-GaitPhase detectPhase(const int fromPose[], const int toPose[]) {
-    int liftCount = 0;
+// Smoothstep in Q15: t² * (3 - 2t), Zwischenergebnis max. 2^30
+int32_t smoothstepQ15(int32_t tQ15) {
+    if (tQ15 <= 0) return 0;
+    if (tQ15 >= Q15_ONE) return Q15_ONE;
+    int32_t t2 = (tQ15 * tQ15) >> 15;
+    return (t2 * (3 * Q15_ONE - 2 * tQ15)) >> 15;
+}
+
+int32_t toQ16(float value) {
+    return (int32_t)(value * (float)Q16_ONE + (value >= 0.0f ? 0.5f : -0.5f));
+}
+
+// Phase-Erkennung für ein Bein über das Delta seines Knee/Paw-Servos
+GaitPhase detectLegPhase(uint8_t leg, const int fromPose[], const int toPose[]) {
+    uint8_t idx = KNEE_SERVO_IDX[leg];
+    int delta = toPose[idx] - fromPose[idx];
     
-    // Nur Knee-Servos (Paws) für Lift-Erkennung prüfen
-    for (uint8_t i = 0; i < KNEE_COUNT; i++) {
-        uint8_t idx = KNEE_SERVO_IDX[i];
-        int delta = toPose[idx] - fromPose[idx];
-        
-        // Lift-Sign berücksichtigen: delta * liftSign > 0 = Bein hebt
-        if (LIFT_SIGN[idx] != 0) {
-            int signedDelta = delta * LIFT_SIGN[idx];
-            if (signedDelta > gaitConfig.timing.liftThreshold) {
-                liftCount++;
-            }
+    // Lift-Sign berücksichtigen: delta * liftSign > 0 = Bein hebt
+    if (LIFT_SIGN[idx] != 0) {
+        int signedDelta = delta * LIFT_SIGN[idx];
+        if (signedDelta > degToFine(gaitConfig.timing.liftThreshold)) {
+            return GaitPhase::SWING;
         }
     }
-    
-    // Mindestens 1 Bein hebt -> Swing-Phase
-    if (liftCount >= 1) {
-        return GaitPhase::SWING;
+    return GaitPhase::STANCE;
+}
+
+// Mindestens 1 Bein hebt -> Swing-Phase
+GaitPhase detectPhase(const int fromPose[], const int toPose[]) {
+    for (uint8_t leg = 0; leg < LEG_COUNT; leg++) {
+        if (detectLegPhase(leg, fromPose, toPose) == GaitPhase::SWING) {
+            return GaitPhase::SWING;
+        }
     }
     return GaitPhase::STANCE;
 }
@@ -58,22 +129,13 @@ GaitPhase detectPhase(const int fromPose[], const int toPose[]) {
 // Stride-Skalierung für einen Servo-Winkel
 int applyStrideScale(int rawAngle, uint8_t servoIdx, float effectiveStride) {
     if (!gaitConfig.stride.enabled || servoIdx >= SERVO_COUNT) {
-        return rawAngle;
+        return degToFine(rawAngle);
     }
     
     int center = gaitConfig.servoLimits[servoIdx].centerAngle;
     float scale = 1.0f;
     
-    // Hip oder Knee?
-    bool isHip = false;
-    for (uint8_t i = 0; i < HIP_COUNT; i++) {
-        if (HIP_SERVO_IDX[i] == servoIdx) {
-            isHip = true;
-            break;
-        }
-    }
-    
-    if (isHip) {
+    if (isHipServo(servoIdx)) {
         // Hip-Servos: volle Stride-Skalierung
         scale = effectiveStride;
     } else {
@@ -86,19 +148,156 @@ int applyStrideScale(int rawAngle, uint8_t servoIdx, float effectiveStride) {
     float delta = (float)(rawAngle - center);
     float scaled = center + delta * scale;
     
-    return (int)(scaled + 0.5f);  // Runden
+    return (int)(scaled * ANGLE_FINE_ONE + 0.5f);  // Runden auf 1/16 Grad
+}
+
+// Stride-Skalierung in Q16, gleiche Rundung wie applyStrideScale()
+int applyStrideScaleQ16(int rawAngle, uint8_t servoIdx, int32_t strideQ16) {
+    if (!gaitConfig.stride.enabled || servoIdx >= SERVO_COUNT) {
+        return degToFine(rawAngle);
+    }
+    
+    int center = gaitConfig.servoLimits[servoIdx].centerAngle;
+    int32_t scaleQ16 = strideQ16;
+    
+    if (!isHipServo(servoIdx)) {
+        scaleQ16 = Q16_ONE + ((fixedParams.kneeMixQ16 * ((strideQ16 - Q16_ONE) >> 4)) >> 12);
+    }
+    
+    const int shift = 16 - ANGLE_FINE_SHIFT;
+    int32_t scaled = ((int32_t)center << 16) + (int32_t)(rawAngle - center) * scaleQ16;
+    return (int)((scaled + (1L << (shift - 1))) >> shift);
 }
 
-// Clamp auf konfigurierte Servo-Limits
+// Clamp auf konfigurierte Servo-Limits (Winkel in 1/16 Grad)
 int clampToLimits(int angle, uint8_t servoIdx) {
     if (servoIdx >= SERVO_COUNT) return angle;
     
     const ServoLimits& limits = gaitConfig.servoLimits[servoIdx];
-    if (angle < limits.minAngle) return limits.minAngle;
-    if (angle > limits.maxAngle) return limits.maxAngle;
+    if (angle < degToFine(limits.minAngle)) return degToFine(limits.minAngle);
+    if (angle > degToFine(limits.maxAngle)) return degToFine(limits.maxAngle);
     return angle;
 }
 
+// Waypoint-Puffer füllen: Stützstelle k liegt bei alpha = (k+1) / count.
+// Easing (Tabellen-Lookup je Servo-Rolle) wird hier einmal pro Segment
+// ausgewertet statt in jedem tick().
+// Beine mit legFinishQ15 < 1 laufen auf gestauchter Zeit: alpha / finish,
+// danach halten sie die Zielpose bis zum Segmentende. Mit legStartQ15 > 0
+// beginnt das Zeitfenster des Beins entsprechend später.
+void buildWaypoints(const int fromPose[], const int toPose[], uint8_t count,
+                    int16_t waypoints[][8], const uint16_t legFinishQ15[],
+                    const uint16_t legStartQ15[]) {
+#if GAIT_FIXED_POINT
+    buildWaypointsFixed(fromPose, toPose, count, waypoints, legFinishQ15, legStartQ15);
+#else
+    buildWaypointsFloat(fromPose, toPose, count, waypoints, legFinishQ15, legStartQ15);
+#endif
+}
+
+// Easing-Kurve je Servo für das aktive Timing-Profil (LINEAR-Interpolation: keine)
+static void servoCurves(EasingCurve curves[]) {
+    for (uint8_t i = 0; i < SERVO_COUNT; i++) {
+        curves[i] = (gaitConfig.interpolation.mode == InterpolationMode::LINEAR)
+            ? EasingCurve::LINEAR
+            : Easing::curveFor(gaitConfig.timing.profile, i);
+    }
+}
+
+void buildWaypointsFloat(const int fromPose[], const int toPose[], uint8_t count,
+                         int16_t waypoints[][8], const uint16_t legFinishQ15[],
+                         const uint16_t legStartQ15[]) {
+    EasingCurve curves[SERVO_COUNT];
+    servoCurves(curves);
+    float legAlpha[LEG_COUNT];
+    
+    for (uint8_t k = 0; k < count; k++) {
+        float alpha = (float)(k + 1) / (float)count;
+        for (uint8_t leg = 0; leg < LEG_COUNT; leg++) {
+            legAlpha[leg] = alpha;
+            if (legStartQ15 && legStartQ15[leg] > 0) {
+                legAlpha[leg] = alpha - (float)legStartQ15[leg] / (float)Q15_ONE;
+                if (legAlpha[leg] < 0.0f) legAlpha[leg] = 0.0f;
+            }
+            if (legFinishQ15 && legFinishQ15[leg] < Q15_ONE) {
+                legAlpha[leg] = legAlpha[leg] * (float)Q15_ONE / (float)legFinishQ15[leg];
+                if (legAlpha[leg] > 1.0f) legAlpha[leg] = 1.0f;
+            }
+        }
+        
+        for (int i = 0; i < SERVO_COUNT; i++) {
+            float eased = Easing::evalFloat(curves[i], legAlpha[SERVO_LEG[i]]);
+            int start = fromPose[i];
+            int target = toPose[i];
+            waypoints[k][i] = (int16_t)(start + (int)((target - start) * eased));
+        }
+    }
+}
+
+void buildWaypointsFixed(const int fromPose[], const int toPose[], uint8_t count,
+                         int16_t waypoints[][8], const uint16_t legFinishQ15[],
+                         const uint16_t legStartQ15[]) {
+    EasingCurve curves[SERVO_COUNT];
+    servoCurves(curves);
+    int32_t legAlphaQ15[LEG_COUNT];
+    
+    for (uint8_t k = 0; k < count; k++) {
+        int32_t alphaQ15 = ((int32_t)(k + 1) << 15) / count;
+        for (uint8_t leg = 0; leg < LEG_COUNT; leg++) {
+            legAlphaQ15[leg] = alphaQ15;
+            if (legStartQ15 && legStartQ15[leg] > 0) {
+                legAlphaQ15[leg] = alphaQ15 - legStartQ15[leg];
+                if (legAlphaQ15[leg] < 0) legAlphaQ15[leg] = 0;
+            }
+            if (legFinishQ15 && legFinishQ15[leg] < Q15_ONE) {
+                legAlphaQ15[leg] = (legAlphaQ15[leg] << 15) / legFinishQ15[leg];
+                if (legAlphaQ15[leg] > Q15_ONE) legAlphaQ15[leg] = Q15_ONE;
+            }
+        }
+        
+        for (int i = 0; i < SERVO_COUNT; i++) {
+            int32_t easedQ15 = Easing::evalQ15(curves[i], legAlphaQ15[SERVO_LEG[i]]);
+            int start = fromPose[i];
+            int delta = toPose[i] - start;
+            // Division statt Shift: rundet wie der Float-Cast Richtung 0
+            waypoints[k][i] = (int16_t)(start + (delta * easedQ15) / Q15_ONE);
+        }
+    }
+}
+
+// Kubische Hermite-Basis: p = p0 + (p1 - p0) * h01 + m0 * h10 + m1 * h11
+void buildSplineWaypoints(const int fromPose[], const int toPose[],
+                          const int m0[], const int m1[], uint8_t count,
+                          int16_t waypoints[][8]) {
+    for (uint8_t k = 0; k < count; k++) {
+#if GAIT_FIXED_POINT
+        int32_t t = ((int32_t)(k + 1) << 15) / count;
+        int32_t t2 = (t * t) >> 15;
+        int32_t t3 = (t2 * t) >> 15;
+        int32_t h01 = 3 * t2 - 2 * t3;
+        int32_t h10 = t3 - 2 * t2 + t;
+        int32_t h11 = t3 - t2;
+        
+        for (int i = 0; i < SERVO_COUNT; i++) {
+            int32_t value = (toPose[i] - fromPose[i]) * h01 + m0[i] * h10 + m1[i] * h11;
+            waypoints[k][i] = (int16_t)(fromPose[i] + value / Q15_ONE);
+        }
+#else
+        float t = (float)(k + 1) / (float)count;
+        float t2 = t * t;
+        float t3 = t2 * t;
+        float h01 = 3.0f * t2 - 2.0f * t3;
+        float h10 = t3 - 2.0f * t2 + t;
+        float h11 = t3 - t2;
+        
+        for (int i = 0; i < SERVO_COUNT; i++) {
+            float value = (toPose[i] - fromPose[i]) * h01 + m0[i] * h10 + m1[i] * h11;
+            waypoints[k][i] = (int16_t)(fromPose[i] + (int)value);
+        }
+#endif
+    }
+}
+
 } // namespace GaitRuntimeInternal
 
 // =============================================================================
@@ -106,183 +305,876 @@ int clampToLimits(int angle, uint8_t servoIdx) {
 // =============================================================================
 namespace GaitRuntime {
 
+// Q16-Parameter nach jeder Float-Änderung neu berechnen, geänderte
+// Parameter außer dem Stride (Teil des Cache-Schlüssels) verwerfen den
+// Segment-Cache
+static void refreshFixedParams() {
+    FixedPointParams params;
+    params.strideQ16 = GaitRuntimeInternal::toQ16(gaitConfig.ramp.currentStride);
+    params.kneeMixQ16 = GaitRuntimeInternal::toQ16(gaitConfig.stride.kneeMix);
+    params.swingMulQ16 = GaitRuntimeInternal::toQ16(gaitConfig.timing.swingMultiplier);
+    params.stanceMulQ16 = GaitRuntimeInternal::toQ16(gaitConfig.timing.stanceMultiplier);
+    
+    bool planChanged = params.kneeMixQ16 != fixedParams.kneeMixQ16 ||
+        params.swingMulQ16 != fixedParams.swingMulQ16 || params.stanceMulQ16 != fixedParams.stanceMulQ16;
+    fixedParams = params;
+    if (planChanged) {
+        invalidateSegmentCache();
+    }
+}
+
 void init() {
+    // Limits gehören der Kalibrierung (ServoCalibration::init() läuft vorher)
+    ServoLimits limits[SERVO_COUNT];
+    for (uint8_t i = 0; i < SERVO_COUNT; i++) limits[i] = gaitConfig.servoLimits[i];
+    
     gaitState = GaitMotionState();
     gaitConfig = GaitRuntimeConfig();
+    for (uint8_t i = 0; i < SERVO_COUNT; i++) gaitConfig.servoLimits[i] = limits[i];
     gaitConfig.validate();
     
     // Versuche gespeicherte Konfiguration zu laden
     loadConfig();
+    refreshFixedParams();
+    Easing::applyConfig();
     
     Serial.println(F("[GaitRuntime] Initialisiert"));
 }
 
-void start(const int matrix[][9], int steps) {
-    if (steps <= 0 || matrix == nullptr) return;
+// Keyframe aus PROGMEM oder über den Reader der Sequenz lesen (Grad),
+// Transformation der Sequenz (Spiegeln, rückwärts) inklusive.
+// Lesefehler: Pose halten statt mit Datenmüll weiterzufahren.
+static int readKeyframe(uint8_t sequence, int step, const int fromPose[], int pose[]) {
+    const GaitSequence& seq = gaitState.chain[sequence];
+    if (seq.keyframes) {
+        return readTableKeyframe(
+            KeyframeTable{ seq.keyframes, (uint16_t)seq.steps, seq.inDefaultLimits, seq.transform },
+            step, pose);
+    }
     
-    gaitState.matrix = matrix;
-    gaitState.totalSteps = steps;
-    gaitState.currentStep = 0;
-    gaitState.sequenceComplete = false;
-    gaitState.isFirstCycle = (gaitState.cycleCount == 0);
+    int row = keyframeSourceStep(seq.steps, seq.transform, step);
+    int durationRow = keyframeDurationStep(seq.steps, seq.transform, step);
+    // Rückwärts stammt die Dauer aus dem Nachbar-Keyframe, vorwärts liest
+    // der Reader zweimal dieselbe Zeile (bei MotionFile aus dem Cache)
+    int durationMs = 0;
+    int rowDuration = 0;
+    int durationPose[SERVO_COUNT];
+    bool ok = seq.reader(durationRow, durationPose, durationMs) &&
+              seq.reader(row, pose, rowDuration);
+    if (!ok) {
+        Serial.printf("[GaitRuntime] Keyframe %d nicht lesbar, Pose wird gehalten\n", step);
+        for (int i = 0; i < SERVO_COUNT; i++) {
+            pose[i] = fineToDeg(fromPose[i]);
+        }
+        return 0;
+    }
+    transformKeyframePose(seq.transform, pose);
+    return durationMs;
+}
+
+// Aktuelle Limits mindestens so weit wie die Default-Limits? Nur dann gilt
+// die Compile-Zeit-Prüfung der Keyframe-Tabellen auch zur Laufzeit.
+static bool limitsCoverDefaults() {
+    for (int i = 0; i < SERVO_COUNT; i++) {
+        const ServoLimits& limits = gaitConfig.servoLimits[i];
+        if (limits.minAngle > SERVO_DEFAULT_MIN_ANGLE || limits.maxAngle < SERVO_DEFAULT_MAX_ANGLE) {
+            return false;
+        }
+    }
+    return true;
+}
+
+// Pose (1/16 Grad) innerhalb der Default-Limits?
+static bool poseInDefaultLimits(const int pose[]) {
+    for (int i = 0; i < SERVO_COUNT; i++) {
+        if (pose[i] < degToFine(SERVO_DEFAULT_MIN_ANGLE) ||
+            pose[i] > degToFine(SERVO_DEFAULT_MAX_ANGLE)) {
+            return false;
+        }
+    }
+    return true;
+}
+
+// Segmentdauer nach Timing-Profil für ein Bein in phase
+static int shapedDuration(int duration, GaitPhase phase) {
+#if GAIT_FIXED_POINT
+    int32_t timingMulQ16 = Q16_ONE;
+    if (gaitConfig.timing.profile == TimingProfile::SWING_STANCE) {
+        timingMulQ16 = (phase == GaitPhase::SWING)
+            ? fixedParams.swingMulQ16
+            : fixedParams.stanceMulQ16;
+    }
+    return (int)(((int32_t)duration * timingMulQ16) >> 16);
+#else
+    float timingMult = 1.0f;
+    if (gaitConfig.timing.profile == TimingProfile::SWING_STANCE) {
+        timingMult = (phase == GaitPhase::SWING)
+            ? gaitConfig.timing.swingMultiplier
+            : gaitConfig.timing.stanceMultiplier;
+    }
+    return (int)(duration * timingMult);
+#endif
+}
+
+// Bewegt sich Hip oder Knee des Beins in diesem Segment?
+static bool legMoves(const GaitSegment& seg, uint8_t leg) {
+    uint8_t hip = HIP_SERVO_IDX[leg];
+    uint8_t knee = KNEE_SERVO_IDX[leg];
+    return seg.scaledToPose[hip] != seg.fromPose[hip] ||
+           seg.scaledToPose[knee] != seg.fromPose[knee];
+}
+
+// Phasen-Rate (timePercent * 3) für ein Segment: 110 - speed, mindestens
+// 15, und so, dass das Segment real mindestens SEGMENT_MIN_MS dauert
+static int32_t phaseRateX3(int adjustedDuration) {
+    int32_t pctX3 = 110 - speedMultiplier;
+    if (pctX3 < 15) pctX3 = 15;
+    int32_t minPctX3 = (SEGMENT_MIN_MS * 300 + adjustedDuration - 1) / adjustedDuration;
+    if (pctX3 < minPctX3) pctX3 = minPctX3;
+    return pctX3;
+}
+
+// Reale Segmentdauer in µs bei aktueller Geschwindigkeit
+static uint32_t realDurationUs(int adjustedDuration) {
+    return (uint32_t)adjustedDuration * 1000 * phaseRateX3(adjustedDuration) / 300;
+}
+
+// Geschätzter Strom je Bein und Waypoint-Intervall: Waypoint k wird zu
+// Beginn seines Intervalls kommandiert und in binUs angefahren
+static void legCurrentProfile(const GaitSegment& seg, uint32_t binUs,
+                              uint16_t load[][MAX_SUB_STEPS]) {
+    for (uint8_t leg = 0; leg < LEG_COUNT; leg++) {
+        for (uint8_t k = 0; k < seg.waypointCount; k++) {
+            load[leg][k] = 0;
+        }
+    }
+    for (uint8_t k = 0; k < seg.waypointCount; k++) {
+        for (uint8_t i = 0; i < SERVO_COUNT; i++) {
+            int prev = (k == 0) ? seg.fromPose[i] : seg.waypoints[k - 1][i];
+            uint32_t ma = estimateCurrentMa(i, abs(seg.waypoints[k][i] - prev), binUs);
+            uint16_t& bin = load[SERVO_LEG[i]][k];
+            bin = (bin + ma > 0xFFFF) ? 0xFFFF : (uint16_t)(bin + ma);
+        }
+    }
+}
+
+// Strombudget für ein vorbereitetes Segment: Beine mit Spielraum (Bein ist
+// vor Segmentende fertig) starten um ganze Waypoint-Intervalle später, wenn
+// sich die Spitzen sonst überlagern. Hip und Knee eines Beins bleiben dabei
+// zusammen, die Fußbahn ändert sich nicht. Liegt die Spitze danach noch über
+// dem Budget, wird das Segment gestreckt (höchstens CURRENT_MAX_STRETCH_PCT).
+static void scheduleCurrent(GaitSegment& seg, bool allowShift) {
+    const CurrentConfig& cfg = gaitConfig.current;
+    uint8_t count = seg.waypointCount;
+    uint32_t binUs = realDurationUs(seg.adjustedDuration) / count;
+    
+    uint16_t load[LEG_COUNT][MAX_SUB_STEPS];
+    legCurrentProfile(seg, binUs, load);
     
-    // Ramp: Stride von current zu target über Zyklen interpolieren
-    if (gaitConfig.ramp.enabled && gaitState.isFirstCycle) {
-        gaitConfig.ramp.currentStride = 0.3f;  // Start klein
+    if (cfg.enabled && allowShift) {
+        // Spitze je Bein, größte zuerst platzieren
+        uint16_t legPeak[LEG_COUNT];
+        uint8_t order[LEG_COUNT];
+        for (uint8_t leg = 0; leg < LEG_COUNT; leg++) {
+            legPeak[leg] = 0;
+            for (uint8_t k = 0; k < count; k++) {
+                if (load[leg][k] > legPeak[leg]) legPeak[leg] = load[leg][k];
+            }
+            uint8_t j = leg;
+            while (j > 0 && legPeak[order[j - 1]] < legPeak[leg]) {
+                order[j] = order[j - 1];
+                j--;
+            }
+            order[j] = leg;
+        }
+        
+        uint32_t total[MAX_SUB_STEPS];
+        for (uint8_t k = 0; k < count; k++) total[k] = 0;
+        bool shifted = false;
+        
+        for (uint8_t n = 0; n < LEG_COUNT; n++) {
+            uint8_t leg = order[n];
+            uint8_t slack = 0;
+            if (legPeak[leg] > 0 && seg.legFinishQ15[leg] < Q15_ONE) {
+                uint32_t busy = ((uint32_t)seg.legFinishQ15[leg] * count + Q15_ONE - 1) >> 15;
+                slack = (uint8_t)(count - busy);
+            }
+            
+            // Erste Verschiebung, die ins Budget passt, sonst die mit der
+            // kleinsten Spitze
+            uint8_t best = 0;
+            uint32_t bestPeak = UINT32_MAX;
+            for (uint8_t s = 0; s <= slack; s++) {
+                uint32_t peak = 0;
+                for (uint8_t k = 0; k < count; k++) {
+                    uint32_t sum = total[k] + (k >= s ? load[leg][k - s] : 0);
+                    if (sum > peak) peak = sum;
+                }
+                if (peak < bestPeak) {
+                    bestPeak = peak;
+                    best = s;
+                }
+                if (peak <= cfg.budgetMa) break;
+            }
+            
+            for (uint8_t k = best; k < count; k++) total[k] += load[leg][k - best];
+            if (best > 0) {
+                seg.legStartQ15[leg] = (uint16_t)(((uint32_t)best << 15) / count);
+                currentStats.shiftedLegs++;
+                shifted = true;
+            }
+        }
+        
+        if (shifted) {
+            GaitRuntimeInternal::buildWaypoints(seg.fromPose, seg.scaledToPose,
+                count, seg.waypoints, seg.legFinishQ15, seg.legStartQ15);
+            legCurrentProfile(seg, binUs, load);
+        }
     }
     
-    // Aktuelle Servo-Positionen als Startpunkt
-    for (int i = 0; i < SERVO_COUNT; i++) {
-        gaitState.fromPose[i] = Running_Servo_POS[i];
-        gaitState.toPose[i] = pgm_read_word(&matrix[0][i]);
+    uint32_t peak = 0;
+    uint32_t sum = 0;
+    for (uint8_t k = 0; k < count; k++) {
+        uint32_t bin = 0;
+        for (uint8_t leg = 0; leg < LEG_COUNT; leg++) bin += load[leg][k];
+        if (bin > peak) peak = bin;
+        sum += bin;
     }
+    uint32_t avg = sum / count;
     
-    // Effektiven Stride berechnen (mit Ramp)
-    float effectiveStride = gaitConfig.ramp.enabled 
-        ? gaitConfig.ramp.currentStride 
-        : gaitConfig.stride.strideFactor;
+    if (cfg.enabled && peak > cfg.budgetMa) {
+        // Strecken: Strom sinkt mit der Geschwindigkeit. Die Dauer wird über
+        // die Basis-Rate umgerechnet, damit SEGMENT_MIN_MS sie nicht schluckt.
+        uint32_t pct = (peak * 100 + cfg.budgetMa - 1) / cfg.budgetMa;
+        if (pct > CURRENT_MAX_STRETCH_PCT) pct = CURRENT_MAX_STRETCH_PCT;
+        uint32_t realUs = realDurationUs(seg.adjustedDuration);
+        uint32_t targetUs = realUs * pct / 100;
+        int32_t baseX3 = 110 - speedMultiplier;
+        if (baseX3 < 15) baseX3 = 15;
+        uint32_t stretched = (targetUs * 3 + baseX3 * 10 - 1) / (baseX3 * 10);
+        if (stretched > 0xFFFF) stretched = 0xFFFF;
+        if (stretched > (uint32_t)seg.adjustedDuration) seg.adjustedDuration = (int)stretched;
+        
+        uint32_t newUs = realDurationUs(seg.adjustedDuration);
+        peak = (uint32_t)((uint64_t)peak * realUs / newUs);
+        avg = (uint32_t)((uint64_t)avg * realUs / newUs);
+        currentStats.stretchedSegments++;
+        if (peak > cfg.budgetMa) currentStats.overBudget++;
+    }
+    
+    seg.currentPeakMa = peak > 0xFFFF ? 0xFFFF : (uint16_t)peak;
+    seg.currentAvgMa = avg > 0xFFFF ? 0xFFFF : (uint16_t)avg;
+}
+
+// Cache-Slot für eine Gangart wählen: vorhandenen Slot derselben Tabelle
+// weiterverwenden, sonst den am längsten ungenutzten neu belegen.
+// Choreografien, Ketten und gestreamte Sequenzen laufen ohne Cache.
+static void selectCacheSlot(const GaitSequence chain[], uint8_t count, bool choreography) {
+    activeCacheSlot = nullptr;
+    if (choreography || count != 1 || chain[0].keyframes == nullptr ||
+        chain[0].steps > SEGMENT_CACHE_STEPS) {
+        return;
+    }
+    
+    SegmentCacheSlot* slot = &segmentCache[0];
+    for (uint8_t i = 0; i < SEGMENT_CACHE_SLOTS; i++) {
+        SegmentCacheSlot& candidate = segmentCache[i];
+        if (candidate.keyframes == chain[0].keyframes && candidate.transform == chain[0].transform) {
+            slot = &candidate;
+            break;
+        }
+        if (candidate.lastUse < slot->lastUse) {
+            slot = &candidate;
+        }
+    }
     
-    // Stride-Skalierung auf Zielpose anwenden
+    if (slot->keyframes != chain[0].keyframes || slot->transform != chain[0].transform) {
+        slot->keyframes = chain[0].keyframes;
+        slot->transform = chain[0].transform;
+        for (uint8_t i = 0; i < SEGMENT_CACHE_STEPS; i++) {
+            slot->entries[i].valid = false;
+        }
+    }
+    slot->lastUse = ++segmentCacheUse;
+    activeCacheSlot = slot;
+}
+
+// Geplantes Segment aus dem Cache übernehmen, falls es ab fromPose mit dem
+// aktuellen Stride gilt
+static bool loadCachedSegment(const CachedSegment& entry, GaitSegment& seg, const int fromPose[]) {
+    if (!entry.valid || entry.strideQ16 != fixedParams.strideQ16) return false;
+    for (int i = 0; i < SERVO_COUNT; i++) {
+        if (entry.fromPose[i] != fromPose[i]) return false;
+    }
+    
+    for (int i = 0; i < SERVO_COUNT; i++) {
+        seg.toPose[i] = entry.toPose[i];
+        seg.scaledToPose[i] = entry.scaledToPose[i];
+    }
+    seg.segmentDuration = entry.segmentDuration;
+    seg.adjustedDuration = entry.adjustedDuration;
+    seg.phase = entry.phase;
+    for (uint8_t leg = 0; leg < LEG_COUNT; leg++) {
+        seg.legPhase[leg] = entry.legPhase[leg];
+        seg.legFinishQ15[leg] = entry.legFinishQ15[leg];
+    }
+    seg.inLimits = entry.inLimits;
+    return true;
+}
+
+static void storeCachedSegment(CachedSegment& entry, const GaitSegment& seg) {
+    for (int i = 0; i < SERVO_COUNT; i++) {
+        entry.fromPose[i] = (int16_t)seg.fromPose[i];
+        entry.toPose[i] = (uint8_t)seg.toPose[i];
+        entry.scaledToPose[i] = (int16_t)seg.scaledToPose[i];
+    }
+    entry.segmentDuration = (uint16_t)seg.segmentDuration;
+    entry.adjustedDuration = (uint16_t)seg.adjustedDuration;
+    entry.phase = seg.phase;
+    for (uint8_t leg = 0; leg < LEG_COUNT; leg++) {
+        entry.legPhase[leg] = seg.legPhase[leg];
+        entry.legFinishQ15[leg] = seg.legFinishQ15[leg];
+    }
+    entry.inLimits = seg.inLimits;
+    entry.strideQ16 = fixedParams.strideQ16;
+    entry.valid = true;
+}
+
+// Keyframe-Winkel mit aktuellem Stride (inkl. Ramp) skaliert und auf die
+// Limits begrenzt, in 1/16 Grad
+static int scaledTarget(int rawAngle, uint8_t servo) {
+#if GAIT_FIXED_POINT
+    int scaled = GaitRuntimeInternal::applyStrideScaleQ16(rawAngle, servo, fixedParams.strideQ16);
+#else
+    int scaled = GaitRuntimeInternal::applyStrideScale(rawAngle, servo, gaitConfig.ramp.currentStride);
+#endif
+    return GaitRuntimeInternal::clampToLimits(scaled, servo);
+}
+
+// Segment für Keyframe step der Sequenz sequence ab fromPose planen:
+// Zielpose skalieren, Phase erkennen und Dauer berechnen (ohne Waypoints).
+static void planSegment(GaitSegment& seg, uint8_t sequence, int step, const int fromPose[]) {
+    seg.sequence = sequence;
+    seg.step = step;
     for (int i = 0; i < SERVO_COUNT; i++) {
-        int scaled = GaitRuntimeInternal::applyStrideScale(
-            gaitState.toPose[i], i, effectiveStride);
-        gaitState.scaledToPose[i] = GaitRuntimeInternal::clampToLimits(scaled, i);
+        seg.fromPose[i] = fromPose[i];
     }
     
-    // Phase erkennen für Timing-Shaping
-    gaitState.currentPhase = GaitRuntimeInternal::detectPhase(
-        gaitState.fromPose, gaitState.scaledToPose);
+    CachedSegment* cached = activeCacheSlot ? &activeCacheSlot->entries[step] : nullptr;
+    if (cached) {
+        if (loadCachedSegment(*cached, seg, fromPose)) {
+            segmentCacheStats.hits++;
+            return;
+        }
+        segmentCacheStats.misses++;
+    }
     
-    // Basis-Timing aus Keyframe
-    int originalTime = pgm_read_word(&matrix[0][8]);
-    int timePercent = (110 - speedMultiplier) / 3;
-    if (timePercent < 5) timePercent = 5;
-    gaitState.segmentDuration = (originalTime * timePercent) / 100;
-    if (gaitState.segmentDuration < 20) gaitState.segmentDuration = 20;
+    int originalTime = readKeyframe(sequence, step, fromPose, seg.toPose);
     
-    // Timing-Shaping anwenden
-    float timingMult = 1.0f;
-    if (gaitConfig.timing.profile == TimingProfile::SWING_STANCE) {
-        timingMult = (gaitState.currentPhase == GaitPhase::SWING)
-            ? gaitConfig.timing.swingMultiplier
-            : gaitConfig.timing.stanceMultiplier;
+    // Choreografie und Stride 1.0 lassen die Keyframes unverändert. Geprüfte
+    // Tabellen brauchen dann keinen Clamp, ebenso ihre Waypoints, solange die
+    // Interpolation zwischen Start und Ziel bleibt (nicht bei Spline-Überschwingen).
+    bool unscaled = gaitState.choreography || !gaitConfig.stride.enabled ||
+                    fixedParams.strideQ16 == Q16_ONE;
+    bool proven = gaitState.chain[sequence].inDefaultLimits && limitsCoverDefaults();
+    seg.inLimits = unscaled && proven && poseInDefaultLimits(fromPose);
+    
+    if (unscaled) {
+        for (int i = 0; i < SERVO_COUNT; i++) {
+            int target = degToFine(seg.toPose[i]);
+            seg.scaledToPose[i] = proven ? target : GaitRuntimeInternal::clampToLimits(target, i);
+        }
+    } else {
+        for (int i = 0; i < SERVO_COUNT; i++) {
+            seg.scaledToPose[i] = scaledTarget(seg.toPose[i], i);
+        }
     }
-    gaitState.adjustedDuration = (int)(gaitState.segmentDuration * timingMult);
-    if (gaitState.adjustedDuration < 15) gaitState.adjustedDuration = 15;
     
-    gaitState.segmentStartMs = millis();
-    gaitState.active = true;
+    // Basis-Timing aus Keyframe (Keyframe-ms, die Geschwindigkeit wirkt erst
+    // bei der Wiedergabe über die Phasen-Rate)
+    seg.segmentDuration = originalTime > 0 ? originalTime : 1;
+    
+    // Phase pro Bein erkennen für Timing-Shaping
+    seg.phase = GaitPhase::STANCE;
+    for (uint8_t leg = 0; leg < LEG_COUNT; leg++) {
+        seg.legPhase[leg] = GaitRuntimeInternal::detectLegPhase(leg, seg.fromPose, seg.scaledToPose);
+        if (seg.legPhase[leg] == GaitPhase::SWING) seg.phase = GaitPhase::SWING;
+        seg.legFinishQ15[leg] = Q15_ONE;
+    }
+    
+    if (gaitState.choreography) {
+        seg.adjustedDuration = seg.segmentDuration;
+        return;
+    }
+    
+    // Timing-Shaping pro Bein: Hip und Knee eines Beins laufen auf dessen
+    // eigener Dauer, das Segment endet mit dem langsamsten bewegten Bein.
+    // Stützbeine bleiben langsam, auch wenn ein anderes Bein schwingt.
+    int legDuration[LEG_COUNT];
+    int slowest = 0;
+    for (uint8_t leg = 0; leg < LEG_COUNT; leg++) {
+        legDuration[leg] = shapedDuration(seg.segmentDuration, seg.legPhase[leg]);
+        if (legMoves(seg, leg) && legDuration[leg] > slowest) {
+            slowest = legDuration[leg];
+        }
+    }
+    if (slowest == 0) {
+        // Kein Bein bewegt sich: wie Stance
+        slowest = shapedDuration(seg.segmentDuration, GaitPhase::STANCE);
+    }
+    seg.adjustedDuration = slowest < 1 ? 1 : slowest;
+    
+    for (uint8_t leg = 0; leg < LEG_COUNT; leg++) {
+        if (legMoves(seg, leg) && legDuration[leg] < seg.adjustedDuration) {
+            seg.legFinishQ15[leg] = (uint16_t)(((int32_t)legDuration[leg] << 15) / seg.adjustedDuration);
+        }
+    }
     
-    Serial.printf("[GaitRuntime] Start: %d steps, stride=%.2f, phase=%s\n", 
-        steps, effectiveStride,
-        gaitState.currentPhase == GaitPhase::SWING ? "SWING" : "STANCE");
+    if (cached) {
+        storeCachedSegment(*cached, seg);
+    }
 }
 
-bool tick(unsigned long nowMs) {
-    if (!gaitState.active) return false;
+// Position nach (sequence, step): nächster Keyframe, sonst erster Keyframe
+// der nächsten Sequenz, Wrap auf den Kettenanfang nur im Looping.
+// Rückgabe: false = Kettenende
+static bool followingPosition(uint8_t& sequence, int& step) {
+    if (step + 1 < gaitState.chain[sequence].steps) {
+        step++;
+        return true;
+    }
+    if (sequence + 1 < gaitState.chainLength) {
+        sequence++;
+    } else if (gaitState.looping) {
+        sequence = 0;
+    } else {
+        return false;
+    }
+    step = 0;
+    return true;
+}
+
+// Segment vollständig vorbereiten: planen und Waypoint-Puffer füllen.
+// prev = vorheriges Segment (nullptr beim Start aus dem Stand).
+static void prepareSegment(GaitSegment& seg, uint8_t sequence, int step, const int fromPose[],
+                           const GaitSegment* prev) {
+    planSegment(seg, sequence, step, fromPose);
+    seg.plannedDuration = seg.adjustedDuration;
+    seg.waypointCount = gaitConfig.interpolation.subSteps;
+    for (uint8_t leg = 0; leg < LEG_COUNT; leg++) {
+        seg.legStartQ15[leg] = 0;
+    }
     
-    // Terrain-Blending ticken
-    terrain_blend_tick();
+    if (gaitConfig.interpolation.mode != InterpolationMode::SPLINE) {
+        GaitRuntimeInternal::buildWaypoints(seg.fromPose, seg.scaledToPose,
+            seg.waypointCount, seg.waypoints, seg.legFinishQ15);
+        scheduleCurrent(seg, !gaitState.choreography);
+        return;
+    }
     
-    unsigned long elapsed = nowMs - gaitState.segmentStartMs;
+    // Die Tangenten gelten für das ganze Segment: beim Spline laufen alle
+    // Beine auf der Zeitbasis des langsamsten Beins
+    seg.inLimits = false;
+    for (uint8_t leg = 0; leg < LEG_COUNT; leg++) {
+        seg.legFinishQ15[leg] = Q15_ONE;
+    }
     
-    // Interpolationsfortschritt berechnen
-    float alpha = (float)elapsed / (float)gaitState.adjustedDuration;
-    if (alpha > 1.0f) alpha = 1.0f;
+    // Hermite-Tangenten aus den Nachbar-Keyframes, zeitgewichtet, damit die
+    // Geschwindigkeit auch bei unterschiedlichen Segmentdauern stetig bleibt:
+    // m = (p[k+1] - p[k-1]) * T / (T_prev + T_next). Start/Ende aus dem Stand = 0.
+    // Gewichtet wird mit den Dauern vor dem Strecken, die der Lookahead auch kennt.
+    static GaitSegment lookahead;
+    int m0[SERVO_COUNT];
+    int m1[SERVO_COUNT];
+    int32_t dur = seg.adjustedDuration;
     
-    // Easing anwenden
-    float eased = gaitConfig.interpolation.smoothstepEnabled 
-        ? GaitRuntimeInternal::smoothstep(alpha)
-        : alpha;
+    uint8_t nextSequence = sequence;
+    int nextStep = step;
+    bool hasNext = followingPosition(nextSequence, nextStep);
+    if (hasNext) {
+        planSegment(lookahead, nextSequence, nextStep, seg.scaledToPose);
+    }
     
-    // Alle Servos interpolieren
     for (int i = 0; i < SERVO_COUNT; i++) {
-        int start = gaitState.fromPose[i];
-        int target = gaitState.scaledToPose[i];
-        int value = start + (int)((target - start) * eased);
-        
-        // Terrain-Offset hinzufügen
-        value += getTerrainAdjustment(i);
-        
-        // Final clampen und setzen
+        m0[i] = prev
+            ? (int)((int32_t)(seg.scaledToPose[i] - prev->fromPose[i]) * dur
+                    / (prev->plannedDuration + dur))
+            : 0;
+        m1[i] = hasNext
+            ? (int)((int32_t)(lookahead.scaledToPose[i] - seg.fromPose[i]) * dur
+                    / (dur + lookahead.adjustedDuration))
+            : 0;
+    }
+    
+    GaitRuntimeInternal::buildSplineWaypoints(seg.fromPose, seg.scaledToPose,
+        m0, m1, seg.waypointCount, seg.waypoints);
+    // Spline: kein Verschieben (Tangenten gelten für alle Beine), nur Strecken
+    scheduleCurrent(seg, false);
+    if (seg.adjustedDuration != dur) {
+        // Gestreckt: Tangenten mit der Dauer skalieren, die Geschwindigkeit an
+        // den Keyframes bleibt damit gleich und der Übergang zu den
+        // Nachbarsegmenten stetig
+        for (int i = 0; i < SERVO_COUNT; i++) {
+            m0[i] = (int)((int32_t)m0[i] * seg.adjustedDuration / dur);
+            m1[i] = (int)((int32_t)m1[i] * seg.adjustedDuration / dur);
+        }
+        GaitRuntimeInternal::buildSplineWaypoints(seg.fromPose, seg.scaledToPose,
+            m0, m1, seg.waypointCount, seg.waypoints);
+    }
+}
+
+// Zyklus abgeschlossen
+static void completeCycle() {
+    gaitState.cycleCount++;
+    
+    if (cycleDurationUs > 0) {
+        currentStats.cyclePeakMa = cyclePeakMa;
+        currentStats.cycleAvgMa = (uint16_t)(cycleChargeMaUs / cycleDurationUs);
+        currentStats.cycles++;
+    }
+    cyclePeakMa = 0;
+    cycleChargeMaUs = 0;
+    cycleDurationUs = 0;
+}
+
+// Strom des abgeschlossenen Segments in den laufenden Zyklus übernehmen
+static void accumulateCurrent(const GaitSegment& seg) {
+    uint32_t realUs = realDurationUs(seg.adjustedDuration);
+    if (seg.currentPeakMa > cyclePeakMa) cyclePeakMa = seg.currentPeakMa;
+    cycleChargeMaUs += (uint64_t)seg.currentAvgMa * realUs;
+    cycleDurationUs += realUs;
+}
+
+// Stride vor jedem Segment Richtung targetStride nachführen: während einer
+// Ramp linear über die restlichen Segmente, sonst max. STRIDE_SLEW_PER_SEGMENT
+static void slewStride() {
+    RampConfig& ramp = gaitConfig.ramp;
+    float delta = ramp.targetStride - ramp.currentStride;
+    if (delta == 0.0f) {
+        gaitState.strideSegmentsLeft = 0;
+        return;
+    }
+    
+    if (gaitState.strideSegmentsLeft > 0) {
+        ramp.currentStride += delta / gaitState.strideSegmentsLeft;
+        gaitState.strideSegmentsLeft--;
+        if (gaitState.strideSegmentsLeft == 0) {
+            ramp.currentStride = ramp.targetStride;
+        }
+    } else if (delta > STRIDE_SLEW_PER_SEGMENT) {
+        ramp.currentStride += STRIDE_SLEW_PER_SEGMENT;
+    } else if (delta < -STRIDE_SLEW_PER_SEGMENT) {
+        ramp.currentStride -= STRIDE_SLEW_PER_SEGMENT;
+    } else {
+        ramp.currentStride = ramp.targetStride;
+    }
+    refreshFixedParams();
+}
+
+// Stride ohne Slew auf strideFactor setzen (Stand, Abbruch)
+static void resetStride() {
+    gaitConfig.ramp.currentStride = gaitConfig.stride.strideFactor;
+    gaitConfig.ramp.targetStride = gaitConfig.stride.strideFactor;
+    gaitState.strideSegmentsLeft = 0;
+    gaitState.stopSegmentsLeft = 0;
+    refreshFixedParams();
+}
+
+// Folgesegment in den freien Puffer legen. Beim Looping wird der Wrap
+// vom letzten auf den ersten Keyframe hier vorbereitet.
+// Rückgabe: false = kein Folgesegment (Sequenzende)
+static bool prepareNextSegment() {
+    uint8_t nextSequence = gaitState.chainIndex;
+    int nextStep = gaitState.currentStep;
+    if (!followingPosition(nextSequence, nextStep)) return false;
+    
+    if (!gaitState.choreography) {
+        slewStride();
+    }
+    
+    const GaitSegment& cur = gaitState.segments[gaitState.activeSegment];
+    prepareSegment(gaitState.segments[gaitState.activeSegment ^ 1], nextSequence, nextStep,
+                   cur.scaledToPose, &cur);
+    gaitState.nextReady = true;
+    return true;
+}
+
+// Startpose: Sub-Grad-Pose übernehmen, außer Legacy-Code hat den Servo bewegt
+static void captureStartPose(int pose[]) {
+    for (int i = 0; i < SERVO_COUNT; i++) {
+        pose[i] = (fineToDeg(currentPoseFine[i]) == Running_Servo_POS[i])
+            ? currentPoseFine[i]
+            : degToFine(Running_Servo_POS[i]);
+    }
+}
+
+// Pose mit Terrain-Offset und Limits ausgeben und als aktuelle Pose merken
+static void writePose(const int pose[]) {
+    for (int i = 0; i < SERVO_COUNT; i++) {
+        int value = pose[i] + degToFine(getTerrainAdjustment(i));
         value = GaitRuntimeInternal::clampToLimits(value, i);
-        Set_PWM_to_Servo(i, value);
+        Set_PWM_to_Servo_Fine(i, value);
+        currentPoseFine[i] = pose[i];
+        Running_Servo_POS[i] = fineToDeg(pose[i]);
     }
+}
+
+// Gemeinsamer Start für Gangarten und Choreografien, erstes Segment fährt
+// den Keyframe startStep der ersten Sequenz an
+static void startKeyframes(const GaitSequence chain[], uint8_t count, bool choreography,
+                           int startStep = 0) {
+    gaitState.source = GaitSource::KEYFRAME;
+    gaitState.chain = chain;
+    gaitState.chainLength = count;
+    gaitState.chainIndex = 0;
+    gaitState.choreography = choreography;
+    gaitState.keyframes = chain[0].keyframes;
+    gaitState.totalSteps = chain[0].steps;
+    gaitState.currentStep = startStep;
+    gaitState.sequenceComplete = false;
+    gaitState.isFirstCycle = (gaitState.cycleCount == 0);
+    gaitState.activeSegment = 0;
+    gaitState.nextReady = false;
+    gaitState.looping = false;
+    gaitState.preempt = false;
+    selectCacheSlot(chain, count, choreography);
+    
+    gaitState.stopSegmentsLeft = 0;
+    refreshFixedParams();
+    
+    // Strom-Zyklus beginnt mit dem ersten Segment
+    cyclePeakMa = 0;
+    cycleChargeMaUs = 0;
+    cycleDurationUs = 0;
+    
+    // Erstes Segment ab aktueller Servo-Position vorbereiten
+    int fromPose[SERVO_COUNT];
+    captureStartPose(fromPose);
+    prepareSegment(gaitState.segments[0], 0, startStep, fromPose, nullptr);
+    gaitState.emittedWaypoint = -1;
+    gaitState.segmentPhaseUs = 0;
+    gaitState.phaseCarry = 0;
+    gaitState.lastTickUs = micros();
+    gaitState.active = true;
+}
+
+void start(const KeyframeTable& table, int startStep) {
+    if (table.steps == 0 || table.rows == nullptr) return;
+    if (startStep < 0 || startStep >= table.steps) startStep = 0;
+    
+    static GaitSequence single;
+    single = GaitSequence(table);
+    startKeyframes(&single, 1, false, startStep);
     
-    // Segment abgeschlossen?
-    if (elapsed >= (unsigned long)gaitState.adjustedDuration) {
-        // Exakte Endposition setzen
+    Serial.printf("[GaitRuntime] Start: %d steps ab %d, stride=%.2f, substeps=%d, phase=%s\n", 
+        table.steps, startStep,
+        gaitConfig.ramp.currentStride,
+        gaitState.segments[0].waypointCount,
+        gaitState.segments[0].phase == GaitPhase::SWING ? "SWING" : "STANCE");
+}
+
+int closestKeyframe(const KeyframeTable& table) {
+    int current[SERVO_COUNT];
+    captureStartPose(current);
+    
+    int best = 0;
+    int32_t bestDistance = INT32_MAX;
+    for (int step = 0; step < table.steps; step++) {
+        int pose[SERVO_COUNT];
+        readTableKeyframe(table, step, pose);
+        int32_t distance = 0;
         for (int i = 0; i < SERVO_COUNT; i++) {
-            int finalValue = gaitState.scaledToPose[i] + getTerrainAdjustment(i);
-            finalValue = GaitRuntimeInternal::clampToLimits(finalValue, i);
-            Set_PWM_to_Servo(i, finalValue);
-            Running_Servo_POS[i] = gaitState.scaledToPose[i];
+            int32_t delta = scaledTarget(pose[i], i) - current[i];
+            distance += delta < 0 ? -delta : delta;
         }
-        
-        // Nächster Step
-        gaitState.currentStep++;
-        
-        if (gaitState.currentStep >= gaitState.totalSteps) {
-            // Sequenz beendet
+        if (distance < bestDistance) {
+            bestDistance = distance;
+            best = step;
+        }
+    }
+    
+    // Pose steht schon auf dem Keyframe: dorthin wäre ein Segment ohne
+    // Bewegung (volle Stance-Dauer), also gleich den folgenden anfahren
+    if (bestDistance < ANGLE_FINE_ONE) {
+        best = (best + 1) % table.steps;
+    }
+    return best;
+}
+
+void startChain(const GaitSequence chain[], uint8_t count) {
+    if (chain == nullptr || count == 0) return;
+    for (uint8_t i = 0; i < count; i++) {
+        if ((chain[i].keyframes == nullptr && chain[i].reader == nullptr) || chain[i].steps <= 0) {
+            return;
+        }
+    }
+    
+    startKeyframes(chain, count, true);
+    
+    Serial.printf("[GaitRuntime] Choreografie: %d Sequenzen, substeps=%d\n",
+        count, gaitState.segments[0].waypointCount);
+}
+
+void startCpg() {
+    gaitState.source = GaitSource::CPG;
+    gaitState.keyframes = nullptr;
+    gaitState.sequenceComplete = false;
+    gaitState.isFirstCycle = (gaitState.cycleCount == 0);
+    gaitState.nextReady = false;
+    gaitState.looping = false;
+    
+    int fromPose[SERVO_COUNT];
+    captureStartPose(fromPose);
+    unsigned long nowMs = millis();
+    CpgGait::begin(nowMs, fromPose);
+    gaitState.lastOutputMs = nowMs;
+    gaitState.active = true;
+    
+    Serial.printf("[GaitRuntime] CPG Start: period=%dms, duty=%.2f, fwd=%.2f, strafe=%.2f, turn=%.2f\n",
+        CpgGait::getPeriodMs(), gaitConfig.cpg.dutyFactor,
+        gaitConfig.cpg.forward, gaitConfig.cpg.strafe, gaitConfig.cpg.turn);
+}
+
+// CPG-Tick: Oszillator vorrücken und Pose ausgeben. Ohne Looping endet die
+// Bewegung an der nächsten Zyklusgrenze in der Ruhepose des Oszillators.
+static bool tickCpg(unsigned long nowMs) {
+    if (nowMs - gaitState.lastOutputMs < CPG_OUTPUT_INTERVAL_MS) return true;
+    gaitState.lastOutputMs = nowMs;
+    
+    int pose[SERVO_COUNT];
+    if (CpgGait::advance(nowMs)) {
+        gaitState.cycleCount++;
+        if (!gaitState.looping) {
+            CpgGait::computeRestPose(pose);
+            writePose(pose);
             gaitState.active = false;
             gaitState.sequenceComplete = true;
-            gaitState.cycleCount++;
-            
-            // Ramp-Update am Zyklusende
-            if (gaitConfig.ramp.enabled && gaitConfig.ramp.rampCycles > 0) {
-                float delta = gaitConfig.ramp.targetStride - gaitConfig.ramp.currentStride;
-                gaitConfig.ramp.currentStride += delta / gaitConfig.ramp.rampCycles;
-                
-                // Ramp beenden wenn Ziel erreicht
-                if (gaitState.cycleCount >= gaitConfig.ramp.rampCycles) {
-                    gaitConfig.ramp.currentStride = gaitConfig.ramp.targetStride;
+            Serial.println(F("[GaitRuntime] CPG beendet"));
+            return false;
+        }
+    }
+    
+    CpgGait::computePose(pose);
+    writePose(pose);
+    return true;
+}
+
+// Keyframe-Zeit vorrücken: sie läuft mit 300 / (110 - speed) gegenüber der
+// Echtzeit (Kennlinie wie bisher timePercent, aber stufenlos wie beim CPG).
+// Der Divisionsrest wird mitgeführt, die Phase driftet dadurch nicht.
+static void advancePhase(unsigned long nowUs, int adjustedDuration) {
+    unsigned long dtUs = nowUs - gaitState.lastTickUs;
+    gaitState.lastTickUs = nowUs;
+    if (dtUs > PHASE_MAX_DT_US) dtUs = PHASE_MAX_DT_US;
+    
+    int32_t pctX3 = phaseRateX3(adjustedDuration);
+    uint32_t num = dtUs * 300 + gaitState.phaseCarry;
+    gaitState.segmentPhaseUs += num / pctX3;
+    gaitState.phaseCarry = num % pctX3;
+}
+
+bool tick(unsigned long nowUs) {
+    if (!gaitState.active) return false;
+    
+    // Terrain-Blending ticken
+    terrain_blend_tick();
+    
+    if (gaitState.source == GaitSource::CPG) {
+        // Zeitbasis des CPG ist millis() wie bei startCpg(): nowUs / 1000
+        // springt beim Überlauf von micros() (alle 71,6 min) gegenüber millis()
+        return tickCpg(millis());
+    }
+    
+    const GaitSegment& seg = gaitState.segments[gaitState.activeSegment];
+    advancePhase(nowUs, seg.adjustedDuration);
+    uint32_t durationUs = (uint32_t)seg.adjustedDuration * 1000;
+    
+    // Fälligen Waypoint auf dem festen Zeitraster bestimmen. Waypoint k wird
+    // zu Beginn seines Intervalls kommandiert, der Servo fährt ihn dann an.
+    if (gaitState.segmentPhaseUs < durationUs) {
+        int due = (int)((gaitState.segmentPhaseUs * seg.waypointCount) / durationUs);
+        if (due != gaitState.emittedWaypoint) {
+            gaitState.emittedWaypoint = (int8_t)due;
+            const int16_t* pose = seg.waypoints[due];
+            for (int i = 0; i < SERVO_COUNT; i++) {
+                // Terrain-Offset hinzufügen, final clampen (außer nachweislich
+                // in den Limits) und setzen
+                int terrain = getTerrainAdjustment(i);
+                int value = pose[i] + degToFine(terrain);
+                if (!seg.inLimits || terrain != 0) {
+                    value = GaitRuntimeInternal::clampToLimits(value, i);
                 }
+                Set_PWM_to_Servo_Fine(i, value);
             }
-            
-            Serial.println(F("[GaitRuntime] Sequenz beendet"));
-            return false;
+        } else if (!gaitState.nextReady) {
+            // Leerlauf-Tick: Folgesegment vorbereiten, solange dieses noch läuft
+            prepareNextSegment();
         }
-        
-        // Nächstes Segment vorbereiten
-        for (int i = 0; i < SERVO_COUNT; i++) {
-            gaitState.fromPose[i] = Running_Servo_POS[i];
-            gaitState.toPose[i] = pgm_read_word(&gaitState.matrix[gaitState.currentStep][i]);
+        return true;
+    }
+    
+    // Segment abgeschlossen: exakte Endposition setzen
+    writePose(seg.scaledToPose);
+    accumulateCurrent(seg);
+    
+    // Vorzeitiges Ende am Keyframe-Wechsel (neue Gangart oder Stop)
+    if (gaitState.preempt) {
+        gaitState.preempt = false;
+        if (gaitState.stopSegmentsLeft > 0) {
+            // Soft-Stop fertig: Folgebewegung (Standby) wieder mit strideFactor
+            resetStride();
         }
-        
-        // Effektiven Stride berechnen
-        float effectiveStride = gaitConfig.ramp.enabled 
-            ? gaitConfig.ramp.currentStride 
-            : gaitConfig.stride.strideFactor;
-        
-        // Stride-Skalierung
-        for (int i = 0; i < SERVO_COUNT; i++) {
-            int scaled = GaitRuntimeInternal::applyStrideScale(
-                gaitState.toPose[i], i, effectiveStride);
-            gaitState.scaledToPose[i] = GaitRuntimeInternal::clampToLimits(scaled, i);
+        gaitState.active = false;
+        gaitState.nextReady = false;
+        gaitState.sequenceComplete = true;
+        Serial.printf("[GaitRuntime] Abbruch nach Keyframe %d\n", gaitState.currentStep);
+        return false;
+    }
+    
+    // Folgesegment sicherstellen (falls kein Leerlauf-Tick dafür übrig war)
+    if (!gaitState.nextReady && !prepareNextSegment()) {
+        // Sequenz beendet
+        if (gaitState.stopSegmentsLeft > 0) {
+            // Soft-Stop endet mit der Tabelle (Looping aufgehoben), nicht erst
+            // am Abbruch: Stride ebenso für die Folgebewegung zurücksetzen
+            resetStride();
         }
+        gaitState.active = false;
+        gaitState.sequenceComplete = true;
+        completeCycle();
         
-        // Phase erkennen
-        gaitState.currentPhase = GaitRuntimeInternal::detectPhase(
-            gaitState.fromPose, gaitState.scaledToPose);
-        
-        // Timing
-        int originalTime = pgm_read_word(&gaitState.matrix[gaitState.currentStep][8]);
-        int timePercent = (110 - speedMultiplier) / 3;
-        if (timePercent < 5) timePercent = 5;
-        gaitState.segmentDuration = (originalTime * timePercent) / 100;
-        if (gaitState.segmentDuration < 20) gaitState.segmentDuration = 20;
-        
-        // Timing-Shaping
-        float timingMult = 1.0f;
-        if (gaitConfig.timing.profile == TimingProfile::SWING_STANCE) {
-            timingMult = (gaitState.currentPhase == GaitPhase::SWING)
-                ? gaitConfig.timing.swingMultiplier
-                : gaitConfig.timing.stanceMultiplier;
-        }
-        gaitState.adjustedDuration = (int)(gaitState.segmentDuration * timingMult);
-        if (gaitState.adjustedDuration < 15) gaitState.adjustedDuration = 15;
-        
-        gaitState.segmentStartMs = nowMs;
+        Serial.println(F("[GaitRuntime] Sequenz beendet"));
+        return false;
+    }
+    
+    // Puffer tauschen. Der Überlauf über das Segmentende wird in das neue
+    // Segment übernommen, damit sich Tick-Verspätungen nicht aufsummieren.
+    uint32_t overshootUs = gaitState.segmentPhaseUs - durationUs;
+    gaitState.activeSegment ^= 1;
+    gaitState.nextReady = false;
+    
+    const GaitSegment& next = gaitState.segments[gaitState.activeSegment];
+    if (next.sequence != gaitState.chainIndex) {
+        gaitState.chainIndex = next.sequence;
+        gaitState.keyframes = gaitState.chain[next.sequence].keyframes;
+        gaitState.totalSteps = gaitState.chain[next.sequence].steps;
+    }
+    gaitState.currentStep = next.step;
+    gaitState.emittedWaypoint = -1;
+    gaitState.segmentPhaseUs = (overshootUs < (uint32_t)next.adjustedDuration * 1000)
+        ? overshootUs
+        : 0;
+    
+    // Wrap auf den Kettenanfang = Zyklus abgeschlossen
+    if (gaitState.currentStep == 0 && gaitState.chainIndex == 0) {
+        completeCycle();
+    }
+    
+    // Soft-Stop: das letzte Segment läuft, danach Abbruch
+    if (gaitState.stopSegmentsLeft > 0 && --gaitState.stopSegmentsLeft == 0) {
+        gaitState.stopSegmentsLeft = 1;
+        gaitState.preempt = true;
+        gaitState.looping = false;
     }
     
     return true;
@@ -290,12 +1182,45 @@ bool tick(unsigned long nowMs) {
 
 void stop() {
     gaitState.active = false;
+    gaitState.looping = false;
+    gaitState.preempt = false;
+    gaitState.nextReady = false;
     gaitState.sequenceComplete = true;
     gaitState.cycleCount = 0;
     gaitState.isFirstCycle = true;
     
     // Ramp zurücksetzen
-    gaitConfig.ramp.currentStride = gaitConfig.stride.strideFactor;
+    resetStride();
+}
+
+void setLooping(bool loop) {
+    if (loop) {
+        // Weiterlaufen hebt einen angeforderten Abbruch bzw. Soft-Stop auf
+        gaitState.preempt = false;
+        if (gaitState.stopSegmentsLeft > 0) {
+            gaitState.stopSegmentsLeft = 0;
+            gaitState.strideSegmentsLeft = 0;
+            gaitConfig.ramp.targetStride = gaitConfig.stride.strideFactor;
+        }
+    }
+    if (gaitState.looping == loop) return;
+    gaitState.looping = loop;
+    
+    // Bereits vorbereiteten Wrap verwerfen bzw. nachholen
+    const GaitSegment& next = gaitState.segments[gaitState.activeSegment ^ 1];
+    if (gaitState.nextReady && next.sequence == 0 && next.step == 0) {
+        gaitState.nextReady = false;
+    }
+}
+
+void preemptAtKeyframe() {
+    if (!gaitState.active || gaitState.source != GaitSource::KEYFRAME) return;
+    gaitState.preempt = true;
+    gaitState.looping = false;
+}
+
+bool isLooping() {
+    return gaitState.looping;
 }
 
 bool isActive() {
@@ -320,6 +1245,15 @@ const GaitMotionState& getState() {
 void setStrideFactor(float factor) {
     gaitConfig.stride.strideFactor = factor;
     gaitConfig.validate();
+    if (!gaitState.active) {
+        resetStride();
+    } else if (gaitState.stopSegmentsLeft == 0 &&
+               gaitConfig.ramp.targetStride != gaitConfig.stride.strideFactor) {
+        // Während des Laufens pro Segment nachführen statt springen
+        gaitConfig.ramp.targetStride = gaitConfig.stride.strideFactor;
+        gaitState.strideSegmentsLeft = 0;
+    }
+    CpgGait::applyConfig();
     Serial.printf("[GaitRuntime] StrideFactor: %.2f\n", gaitConfig.stride.strideFactor);
 }
 
@@ -329,31 +1263,103 @@ void setSubSteps(uint8_t steps) {
     Serial.printf("[GaitRuntime] SubSteps: %d\n", gaitConfig.interpolation.subSteps);
 }
 
+void setInterpolationMode(InterpolationMode mode) {
+    gaitConfig.interpolation.mode = mode;
+    gaitConfig.validate();
+    Serial.printf("[GaitRuntime] Interpolation: %d\n", (int)gaitConfig.interpolation.mode);
+}
+
 void setTimingProfile(TimingProfile profile) {
-    gaitConfig.timing.profile = profile;
+    if (gaitConfig.timing.profile != profile) {
+        gaitConfig.timing.profile = profile;
+        invalidateSegmentCache();
+    }
     Serial.printf("[GaitRuntime] TimingProfile: %d\n", (int)profile);
 }
 
 void setSwingMultiplier(float mult) {
     gaitConfig.timing.swingMultiplier = mult;
     gaitConfig.validate();
+    refreshFixedParams();
 }
 
 void setStanceMultiplier(float mult) {
     gaitConfig.timing.stanceMultiplier = mult;
     gaitConfig.validate();
+    refreshFixedParams();
 }
 
 void enableRamp(bool enable, uint8_t cycles) {
     gaitConfig.ramp.enabled = enable;
     gaitConfig.ramp.rampCycles = cycles;
     gaitConfig.validate();
+    Serial.printf("[GaitRuntime] Ramp: %s, cycles=%d\n", enable ? "ON" : "OFF", cycles);
+}
+
+void setEasing(TimingProfile profile, EasingCurve hip, EasingCurve knee) {
+    if ((uint8_t)profile >= TIMING_PROFILE_COUNT) return;
     
-    if (enable) {
-        gaitState.cycleCount = 0;
-        gaitState.isFirstCycle = true;
+    gaitConfig.easing.hip[(uint8_t)profile] = hip;
+    gaitConfig.easing.knee[(uint8_t)profile] = knee;
+    gaitConfig.validate();
+    Serial.printf("[GaitRuntime] Easing Profil %d: hip=%d, knee=%d\n",
+        (int)profile, (int)gaitConfig.easing.hip[(uint8_t)profile],
+        (int)gaitConfig.easing.knee[(uint8_t)profile]);
+}
+
+void setEasingCustom(const uint8_t points[]) {
+    for (uint8_t i = 0; i < EASING_CUSTOM_POINTS; i++) {
+        gaitConfig.easing.custom[i] = points[i];
     }
-    Serial.printf("[GaitRuntime] Ramp: %s, cycles=%d\n", enable ? "ON" : "OFF", cycles);
+    gaitConfig.validate();
+    Easing::applyConfig();
+    Serial.println(F("[GaitRuntime] Easing-Benutzerkurve gesetzt"));
+}
+
+void setSlewLimits(uint8_t servo, uint16_t maxVelocity, uint16_t maxAccel) {
+    for (uint8_t i = 0; i < SERVO_COUNT; i++) {
+        if (servo != 0xFF && servo != i) continue;
+        gaitConfig.slew.maxVelocity[i] = maxVelocity;
+        gaitConfig.slew.maxAccel[i] = maxAccel;
+    }
+    gaitConfig.validate();
+    Serial.printf("[GaitRuntime] Slew-Limits Servo %d: %d Grad/s, %d Grad/s^2\n",
+        servo == 0xFF ? -1 : (int)servo, maxVelocity, maxAccel);
+}
+
+void enableSlewLimit(bool enable) {
+    gaitConfig.slew.enabled = enable;
+    Serial.printf("[GaitRuntime] Slew-Limiter: %s\n", enable ? "ON" : "OFF");
+}
+
+void setPwmStagger(uint16_t staggerUs) {
+    gaitConfig.pwm.staggerUs = staggerUs;
+    gaitConfig.validate();
+    Serial.printf("[GaitRuntime] PWM-Versatz: %d µs\n", gaitConfig.pwm.staggerUs);
+}
+
+void setCurrentBudget(bool enabled, uint16_t budgetMa) {
+    gaitConfig.current.enabled = enabled;
+    gaitConfig.current.budgetMa = budgetMa;
+    gaitConfig.validate();
+    Serial.printf("[GaitRuntime] Strombudget: %s, %d mA\n",
+        enabled ? "ON" : "OFF", gaitConfig.current.budgetMa);
+}
+
+void setCurrentModel(uint16_t hipMaPer100Dps, uint16_t kneeMaPer100Dps) {
+    gaitConfig.current.hipMaPer100Dps = hipMaPer100Dps;
+    gaitConfig.current.kneeMaPer100Dps = kneeMaPer100Dps;
+    gaitConfig.validate();
+    Serial.printf("[GaitRuntime] Strommodell: hip=%d, knee=%d mA pro 100 Grad/s\n",
+        gaitConfig.current.hipMaPer100Dps, gaitConfig.current.kneeMaPer100Dps);
+}
+
+const CurrentStats& getCurrentStats() {
+    return currentStats;
+}
+
+void resetCurrentStats() {
+    currentStats = CurrentStats();
 }
 
 void setServoLimits(uint8_t servo, int minAngle, int maxAngle, int centerAngle) {
@@ -362,17 +1368,109 @@ void setServoLimits(uint8_t servo, int minAngle, int maxAngle, int centerAngle)
     gaitConfig.servoLimits[servo].minAngle = minAngle;
     gaitConfig.servoLimits[servo].maxAngle = maxAngle;
     gaitConfig.servoLimits[servo].centerAngle = centerAngle;
+    invalidateSegmentCache();
     
     Serial.printf("[GaitRuntime] Servo %d limits: %d-%d, center=%d\n", 
         servo, minAngle, maxAngle, centerAngle);
 }
 
+void invalidateSegmentCache() {
+    for (uint8_t s = 0; s < SEGMENT_CACHE_SLOTS; s++) {
+        for (uint8_t i = 0; i < SEGMENT_CACHE_STEPS; i++) {
+            segmentCache[s].entries[i].valid = false;
+        }
+    }
+    segmentCacheStats.invalidations++;
+}
+
+const SegmentCacheStats& getSegmentCacheStats() {
+    return segmentCacheStats;
+}
+
+void setCpgGaitType(CpgGaitType type) {
+    gaitConfig.cpg.setGaitType(type);
+    CpgGait::applyConfig();
+    Serial.printf("[GaitRuntime] CPG Gangart: %s\n", type == CpgGaitType::TROT ? "trot" : "creep");
+}
+
+void setCpgParams(float dutyFactor, float stepHeight, float strideDeg, uint16_t basePeriodMs) {
+    gaitConfig.cpg.dutyFactor = dutyFactor;
+    gaitConfig.cpg.stepHeight = stepHeight;
+    gaitConfig.cpg.strideDeg = strideDeg;
+    gaitConfig.cpg.basePeriodMs = basePeriodMs;
+    gaitConfig.cpg.validate();
+    CpgGait::applyConfig();
+}
+
+void setCpgPhaseOffset(uint8_t leg, float offset) {
+    if (leg >= LEG_COUNT) return;
+    gaitConfig.cpg.phaseOffset[leg] = offset;
+    gaitConfig.cpg.validate();
+    CpgGait::applyConfig();
+}
+
+void setCpgCommand(float forward, float strafe, float turn) {
+    gaitConfig.cpg.forward = forward;
+    gaitConfig.cpg.strafe = strafe;
+    gaitConfig.cpg.turn = turn;
+    gaitConfig.cpg.validate();
+    CpgGait::applyConfig();
+}
+
+void setCpgIk(bool enabled, float strideMm) {
+    gaitConfig.cpg.ikEnabled = enabled;
+    gaitConfig.cpg.strideMm = strideMm;
+    gaitConfig.cpg.validate();
+    CpgGait::applyConfig();
+    Serial.printf("[GaitRuntime] CPG IK: %s, stride=%.1fmm\n", enabled ? "ON" : "OFF",
+        gaitConfig.cpg.strideMm);
+}
+
+void setLegGeometry(const LegGeometry& geometry) {
+    gaitConfig.leg = geometry;
+    gaitConfig.leg.validate();
+    CpgGait::applyConfig();
+}
+
 void setTargetStride(float target) {
+    if (gaitState.stopSegmentsLeft > 0) return;
     gaitConfig.ramp.targetStride = target;
-    if (target < 0.3f) gaitConfig.ramp.targetStride = 0.3f;
+    if (target < STRIDE_RAMP_MIN) gaitConfig.ramp.targetStride = STRIDE_RAMP_MIN;
     if (target > 2.0f) gaitConfig.ramp.targetStride = 2.0f;
 }
 
+void setRampStopSegments(uint8_t segments) {
+    gaitConfig.ramp.stopSegments = segments;
+    gaitConfig.validate();
+    Serial.printf("[GaitRuntime] Soft-Stop: %d Segmente\n", gaitConfig.ramp.stopSegments);
+}
+
+void rampUpFromRest(uint16_t segments) {
+    if (!gaitConfig.ramp.enabled || segments == 0) return;
+    gaitConfig.ramp.currentStride = STRIDE_RAMP_MIN;
+    gaitConfig.ramp.targetStride = gaitConfig.stride.strideFactor;
+    gaitState.strideSegmentsLeft = segments;
+    refreshFixedParams();
+}
+
+bool softStop() {
+    if (!gaitConfig.ramp.enabled || !gaitState.active ||
+        gaitState.source != GaitSource::KEYFRAME || gaitState.choreography) {
+        return false;
+    }
+    if (gaitState.stopSegmentsLeft > 0) return true;
+    
+    gaitConfig.ramp.targetStride = STRIDE_RAMP_MIN;
+    gaitState.strideSegmentsLeft = gaitConfig.ramp.stopSegments;
+    gaitState.stopSegmentsLeft = gaitConfig.ramp.stopSegments;
+    Serial.printf("[GaitRuntime] Soft-Stop über %d Segmente\n", gaitConfig.ramp.stopSegments);
+    return true;
+}
+
+bool isSoftStopping() {
+    return gaitState.stopSegmentsLeft > 0;
+}
+
 // =============================================================================
 // Persistenz (LittleFS)
 // =============================================================================
@@ -403,6 +1501,15 @@ bool saveConfig() {
         f.write((uint8_t*)&gaitConfig.servoLimits[i], sizeof(ServoLimits));
     }
     
+    // CPG, Bein-Geometrie, Easing, Slew-Limiter, PWM und Strombudget
+    // (angehängt, ältere Dateien enden vorher)
+    f.write((uint8_t*)&gaitConfig.cpg, sizeof(CpgConfig));
+    f.write((uint8_t*)&gaitConfig.leg, sizeof(LegGeometry));
+    f.write((uint8_t*)&gaitConfig.easing, sizeof(EasingConfig));
+    f.write((uint8_t*)&gaitConfig.slew, sizeof(SlewConfig));
+    f.write((uint8_t*)&gaitConfig.pwm, sizeof(PwmConfig));
+    f.write((uint8_t*)&gaitConfig.current, sizeof(CurrentConfig));
+    
     f.close();
     Serial.println(F("[GaitRuntime] Config saved"));
     return true;
@@ -433,15 +1540,117 @@ bool loadConfig() {
     // Interpolation
     f.read((uint8_t*)&gaitConfig.interpolation, sizeof(InterpolationConfig));
     
-    // Servo-Limits
+    // Servo-Limits: nur noch Platzhalter im Dateiformat, die Limits kommen
+    // aus der Kalibrierung
     for (uint8_t i = 0; i < SERVO_COUNT; i++) {
-        f.read((uint8_t*)&gaitConfig.servoLimits[i], sizeof(ServoLimits));
+        ServoLimits ignored;
+        f.read((uint8_t*)&ignored, sizeof(ServoLimits));
+    }
+    
+    // CPG
+    if (f.available() >= (int)sizeof(CpgConfig)) {
+        f.read((uint8_t*)&gaitConfig.cpg, sizeof(CpgConfig));
+    }
+    
+    // Bein-Geometrie
+    if (f.available() >= (int)sizeof(LegGeometry)) {
+        f.read((uint8_t*)&gaitConfig.leg, sizeof(LegGeometry));
+    }
+    
+    // Easing
+    if (f.available() >= (int)sizeof(EasingConfig)) {
+        f.read((uint8_t*)&gaitConfig.easing, sizeof(EasingConfig));
+    }
+    
+    // Slew-Limiter
+    if (f.available() >= (int)sizeof(SlewConfig)) {
+        f.read((uint8_t*)&gaitConfig.slew, sizeof(SlewConfig));
+    }
+    
+    // PWM-Versatz
+    if (f.available() >= (int)sizeof(PwmConfig)) {
+        f.read((uint8_t*)&gaitConfig.pwm, sizeof(PwmConfig));
+    }
+    
+    // Strombudget
+    if (f.available() >= (int)sizeof(CurrentConfig)) {
+        f.read((uint8_t*)&gaitConfig.current, sizeof(CurrentConfig));
     }
     
     f.close();
     gaitConfig.validate();
+    invalidateSegmentCache();
+    resetStride();
+    CpgGait::applyConfig();
+    Easing::applyConfig();
     Serial.println(F("[GaitRuntime] Config loaded"));
     return true;
 }
 
+// =============================================================================
+// Benchmark: Float- gegen Fixed-Point-Pfad (ESP.getCycleCount)
+// =============================================================================
+BenchmarkResult benchmark(const KeyframeTable& table) {
+    BenchmarkResult result = { 0, 0, 0 };
+    const int steps = table.steps;
+    if (steps <= 0 || table.rows == nullptr) return result;
+    
+    static int16_t wpFloat[MAX_SUB_STEPS][8];
+    static int16_t wpFixed[MAX_SUB_STEPS][8];
+    const uint8_t count = gaitConfig.interpolation.subSteps;
+    const float stride = gaitConfig.stride.strideFactor;
+    const int32_t strideQ16 = GaitRuntimeInternal::toQ16(stride);
+    
+    int fromPose[SERVO_COUNT];
+    int rawPose[SERVO_COUNT];
+    int poseFloat[SERVO_COUNT];
+    int poseFixed[SERVO_COUNT];
+    readTableKeyframe(table, steps - 1, rawPose);
+    for (int i = 0; i < SERVO_COUNT; i++) {
+        fromPose[i] = degToFine(rawPose[i]);
+    }
+    
+    for (int step = 0; step < steps; step++) {
+        int baseTime = readTableKeyframe(table, step, rawPose);
+        
+        // Float-Pfad
+        uint32_t t0 = ESP.getCycleCount();
+        for (int i = 0; i < SERVO_COUNT; i++) {
+            poseFloat[i] = GaitRuntimeInternal::clampToLimits(
+                GaitRuntimeInternal::applyStrideScale(rawPose[i], i, stride), i);
+        }
+        volatile int durFloat = (int)(baseTime * gaitConfig.timing.swingMultiplier);
+        GaitRuntimeInternal::buildWaypointsFloat(fromPose, poseFloat, count, wpFloat);
+        uint32_t t1 = ESP.getCycleCount();
+        
+        // Fixed-Point-Pfad
+        for (int i = 0; i < SERVO_COUNT; i++) {
+            poseFixed[i] = GaitRuntimeInternal::clampToLimits(
+                GaitRuntimeInternal::applyStrideScaleQ16(rawPose[i], i, strideQ16), i);
+        }
+        volatile int durFixed = (int)(((int32_t)baseTime * fixedParams.swingMulQ16) >> 16);
+        GaitRuntimeInternal::buildWaypointsFixed(fromPose, poseFixed, count, wpFixed);
+        uint32_t t2 = ESP.getCycleCount();
+        
+        result.floatCycles += t1 - t0;
+        result.fixedCycles += t2 - t1;
+        (void)durFloat;
+        (void)durFixed;
+        
+        for (uint8_t k = 0; k < count; k++) {
+            for (int i = 0; i < SERVO_COUNT; i++) {
+                int diff = abs(wpFloat[k][i] - wpFixed[k][i]);
+                if (diff > result.maxDiffFine) result.maxDiffFine = diff;
+            }
+        }
+        for (int i = 0; i < SERVO_COUNT; i++) {
+            fromPose[i] = poseFloat[i];
+        }
+    }
+    
+    Serial.printf("[GaitRuntime] Benchmark %d steps x %d substeps: float=%u cyc, fixed=%u cyc, maxDiff=%d/16 deg\n",
+        steps, count, result.floatCycles, result.fixedCycles, result.maxDiffFine);
+    return result;
+}
+
 } // namespace GaitRuntime
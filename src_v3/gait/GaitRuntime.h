@@ -13,6 +13,7 @@
 
 #include <Arduino.h>
 #include "GaitConfig.h"
+#include "../motion/Keyframe.h"
 
 // =============================================================================
 // Phase-Erkennung für Timing-Shaping
@@ -23,46 +24,154 @@ enum class GaitPhase : uint8_t {
     STANCE      // Bein am Boden -> langsamer für Stabilität
 };
 
+// =============================================================================
+// Quelle der Bewegung
+// =============================================================================
+enum class GaitSource : uint8_t {
+    KEYFRAME = 0,   // PROGMEM-Matrix, Segment-Pipeline
+    CPG             // Phasen-Oszillator (CpgGait)
+};
+
+// =============================================================================
+// Keyframe-Sequenz (PROGMEM-Tabelle) als Glied einer Kette
+// =============================================================================
+// Choreografien bestehen aus mehreren Sequenzen (z.B. Hello = Winken + Standby),
+// die GaitRuntime nahtlos nacheinander abspielt. Ohne Tabelle liefert reader
+// die Keyframes (z.B. gestreamt aus einer Datei, siehe MotionFile).
+// =============================================================================
+// Keyframe step lesen: pose in Grad, Rückgabe false = Lesefehler
+typedef bool (*KeyframeReader)(int step, int pose[], int& durationMs);
+
+struct GaitSequence {
+    const Keyframe* keyframes;     // PROGMEM-Tabelle oder nullptr
+    int steps;
+    KeyframeReader reader;         // nur ohne Tabelle
+    bool inDefaultLimits;          // Beim Kompilieren gegen Default-Limits geprüft
+    uint8_t transform;             // KEYFRAME_* Bitmaske (Spiegeln, rückwärts)
+    
+    GaitSequence() : keyframes(nullptr), steps(0), reader(nullptr), inDefaultLimits(false), transform(0) {}
+    GaitSequence(const KeyframeTable& table)
+        : keyframes(table.rows), steps(table.steps), reader(nullptr),
+          inDefaultLimits(table.inDefaultLimits), transform(table.transform) {}
+    GaitSequence(KeyframeReader keyframeReader, int count, uint8_t keyframeTransform = 0)
+        : keyframes(nullptr), steps(count), reader(keyframeReader), inDefaultLimits(false),
+          transform(keyframeTransform) {}
+};
+
+// =============================================================================
+// Vorbereitetes Keyframe-Segment
+// =============================================================================
+struct GaitSegment {
+    uint8_t sequence;              // Index in der Sequenz-Kette
+    int step;                      // Keyframe-Index in der Matrix
+    int segmentDuration;           // Basis-Duration aus Keyframe (Keyframe-ms, vor Speed)
+    int adjustedDuration;          // Nach Timing-Shaping angepasst (Keyframe-ms)
+    int plannedDuration;           // adjustedDuration vor dem Strecken durch das Strombudget
+    int fromPose[8];               // Startpose in 1/16 Grad
+    int toPose[8];                 // Keyframe-Rohwerte in Grad
+    int scaledToPose[8];           // Nach Stride-Skalierung, in 1/16 Grad
+    GaitPhase phase;               // SWING, sobald ein Bein hebt
+    GaitPhase legPhase[LEG_COUNT]; // Phase je Bein (UR, LR, UL, LL)
+    uint16_t legFinishQ15[LEG_COUNT]; // Bein am Ziel nach diesem Anteil der Segmentdauer (Q15)
+    uint16_t legStartQ15[LEG_COUNT];  // Strombudget: Bein startet erst nach diesem Anteil (Q15)
+    bool inLimits;                 // Alle Waypoints nachweislich in den Limits (kein Clamp)
+    uint16_t currentPeakMa;        // Geschätzter Spitzenstrom aller Servos im Segment
+    uint16_t currentAvgMa;         // Geschätzter mittlerer Strom
+    
+    // Waypoint-Puffer (1/16 Grad): pro Segment einmal berechnet, tick() gibt nur aus
+    int16_t waypoints[MAX_SUB_STEPS][8];
+    uint8_t waypointCount;         // = subSteps beim Vorbereiten
+    
+    GaitSegment() {
+        sequence = 0;
+        step = 0;
+        segmentDuration = 0;
+        adjustedDuration = 0;
+        plannedDuration = 0;
+        phase = GaitPhase::UNKNOWN;
+        inLimits = false;
+        currentPeakMa = 0;
+        currentAvgMa = 0;
+        for (int leg = 0; leg < LEG_COUNT; leg++) {
+            legPhase[leg] = GaitPhase::UNKNOWN;
+            legFinishQ15[leg] = Q15_ONE;
+            legStartQ15[leg] = 0;
+        }
+        waypointCount = 0;
+        for (int i = 0; i < 8; i++) {
+            fromPose[i] = degToFine(90);
+            toPose[i] = 90;
+            scaledToPose[i] = degToFine(90);
+        }
+    }
+};
+
 // =============================================================================
 // Erweiterter Motion State
 // =============================================================================
+// Double-Buffer: segments[activeSegment] wird abgespielt, das andere Segment
+// wird währenddessen vorbereitet (inkl. Wrap letzter -> erster Keyframe).
+// =============================================================================
 struct GaitMotionState {
     // Basis-State (kompatibel mit MotionState)
     volatile bool active;
-    unsigned long segmentStartMs;
-    int segmentDuration;           // Basis-Duration aus Keyframe
-    int adjustedDuration;          // Nach Timing-Shaping angepasst
+    uint32_t segmentPhaseUs;       // Fortschritt im Segment in Keyframe-µs
+    uint32_t phaseCarry;           // Divisionsrest der Phasen-Rate
+    unsigned long lastTickUs;
     int currentStep;
     int totalSteps;
-    int fromPose[8];
-    int toPose[8];
-    int scaledToPose[8];           // Nach Stride-Skalierung
-    const int (*matrix)[9];
+    const Keyframe* keyframes;     // Tabelle der aktiven Sequenz (nullptr bei Reader)
     bool sequenceComplete;
+    GaitSource source;
+    
+    // Sequenz-Kette (start() nutzt eine Kette mit einem Glied)
+    const GaitSequence* chain;
+    uint8_t chainLength;
+    uint8_t chainIndex;            // Sequenz des aktiven Segments
+    bool choreography;             // Rohwiedergabe: ohne Stride-Skalierung und Timing-Shaping
+    unsigned long lastOutputMs;    // CPG: letzte Ausgabe
+    
+    // Segment-Pipeline
+    GaitSegment segments[2];
+    uint8_t activeSegment;
+    bool nextReady;                // Folgesegment vorbereitet
+    bool looping;                  // Kontinuierlich: nach letztem Keyframe weiter mit 0
+    bool preempt;                  // Am Ende des laufenden Segments beenden
+    int8_t emittedWaypoint;        // Zuletzt ausgegebener Waypoint (-1 = keiner)
     
     // Erweiterte State-Felder
-    GaitPhase currentPhase;
-    int cycleCount;                // Für Ramp-Berechnung
+    int cycleCount;
     bool isFirstCycle;
+    uint16_t strideSegmentsLeft;   // Ramp: Segmente bis targetStride (0 = Slew mit STRIDE_SLEW_PER_SEGMENT)
+    uint8_t stopSegmentsLeft;      // Soft-Stop: Segmente bis zum Abbruch (0 = kein Soft-Stop)
     
     GaitMotionState() {
         active = false;
-        segmentStartMs = 0;
-        segmentDuration = 0;
-        adjustedDuration = 0;
+        segmentPhaseUs = 0;
+        phaseCarry = 0;
+        lastTickUs = 0;
         currentStep = 0;
         totalSteps = 0;
-        matrix = nullptr;
+        keyframes = nullptr;
         sequenceComplete = false;
-        currentPhase = GaitPhase::UNKNOWN;
+        source = GaitSource::KEYFRAME;
+        chain = nullptr;
+        chainLength = 0;
+        chainIndex = 0;
+        choreography = false;
+        lastOutputMs = 0;
+        activeSegment = 0;
+        nextReady = false;
+        looping = false;
+        preempt = false;
+        emittedWaypoint = -1;
         cycleCount = 0;
         isFirstCycle = true;
-        for (int i = 0; i < 8; i++) {
-            fromPose[i] = 90;
-            toPose[i] = 90;
-            scaledToPose[i] = 90;
-        }
+        strideSegmentsLeft = 0;
+        stopSegmentsLeft = 0;
     }
+    
+    const GaitSegment& current() const { return segments[activeSegment]; }
 };
 
 // =============================================================================
@@ -73,15 +182,35 @@ namespace GaitRuntime {
 // Initialisierung
 void init();
 
-// Motion starten (erweitert)
-void start(const int matrix[][9], int steps);
+// Motion starten (erweitert), erstes Segment fährt Keyframe startStep an
+void start(const KeyframeTable& table, int startStep = 0);
 
-// Motion Tick - Rückgabe: true = läuft noch
-bool tick(unsigned long nowMs);
+// Keyframe der Tabelle, der der aktuellen Pose am nächsten liegt
+// (Summe der Winkelabstände zur skalierten Zielpose, Transformation der
+// Tabelle inklusive). Steht die Pose bereits darauf, der folgende Keyframe.
+int closestKeyframe(const KeyframeTable& table);
+
+// Choreografie starten: Sequenzen nacheinander, Keyframes unverändert
+// (Timing wie Servo_PROGRAM_Run). chain muss bis zum Ende gültig bleiben.
+void startChain(const GaitSequence chain[], uint8_t count);
+
+// CPG-Gait starten (Parameter aus gaitConfig.cpg)
+void startCpg();
+
+// Motion Tick (nowUs = micros()) - Rückgabe: true = läuft noch
+bool tick(unsigned long nowUs);
 
 // Motion stoppen
 void stop();
 
+// Kontinuierlich: Sequenz ohne Neustart wiederholen (false = nach Zyklus enden)
+void setLooping(bool loop);
+bool isLooping();
+
+// Keyframe-Bewegung am Ende des laufenden Segments beenden statt am
+// Sequenzende (tick() liefert dann false, die Pose steht auf dem Keyframe)
+void preemptAtKeyframe();
+
 // Status-Abfragen
 bool isActive();
 bool isSequenceComplete();
@@ -93,40 +222,140 @@ const GaitMotionState& getState();
 // Konfiguration zur Laufzeit ändern
 void setStrideFactor(float factor);
 void setSubSteps(uint8_t steps);
+void setInterpolationMode(InterpolationMode mode);
 void setTimingProfile(TimingProfile profile);
 void setSwingMultiplier(float mult);
 void setStanceMultiplier(float mult);
 void enableRamp(bool enable, uint8_t cycles = 3);
+void setRampStopSegments(uint8_t segments);
+
+// Soft-Start: Stride ab STRIDE_RAMP_MIN über segments Segmente auf strideFactor
+// (vor start() aufrufen, ohne Ramp wirkungslos)
+void rampUpFromRest(uint16_t segments);
+
+// Soft-Stop: Gangart läuft weiter, Stride schrumpft über ramp.stopSegments
+// Segmente auf STRIDE_RAMP_MIN, dann Abbruch am Keyframe wie preemptAtKeyframe().
+// Rückgabe: false = kein Soft-Stop möglich (Ramp aus, keine Keyframe-Gangart)
+bool softStop();
+bool isSoftStopping();
+
+// Easing-Kurven pro Timing-Profil für Hip- und Knee-Servos (wirken ab dem nächsten Segment)
+void setEasing(TimingProfile profile, EasingCurve hip, EasingCurve knee);
+// Benutzerkurve: EASING_CUSTOM_POINTS Werte in Prozent bei 0, 1/8, ..., 1
+void setEasingCustom(const uint8_t points[]);
 
-// Servo-Limits pro Servo setzen (für Kalibrierung)
+// Slew-Limiter: Grenzen in Grad/s bzw. Grad/s² (servo 0xFF = alle Servos)
+void setSlewLimits(uint8_t servo, uint16_t maxVelocity, uint16_t maxAccel);
+void enableSlewLimit(bool enable);
+
+// PWM-Ausgabe: Versatz der Pulsstarts zwischen zwei Kanälen (0 = alle gleichzeitig)
+void setPwmStagger(uint16_t staggerUs);
+
+// Servo-Limits pro Servo setzen. Nur ServoCalibration ruft das auf, die
+// Limits in gaitConfig sind eine Kopie der Kalibrierung für die Planung.
 void setServoLimits(uint8_t servo, int minAngle, int maxAngle, int centerAngle);
 
-// Stride-Ziel setzen (für Ramp)
+// Stride-Ziel setzen (für Ramp), der Stride folgt pro Segment
 void setTargetStride(float target);
 
+// CPG-Parameter (wirken sofort, ohne Neustart)
+void setCpgGaitType(CpgGaitType type);
+void setCpgParams(float dutyFactor, float stepHeight, float strideDeg, uint16_t basePeriodMs);
+void setCpgPhaseOffset(uint8_t leg, float offset);
+void setCpgCommand(float forward, float strafe, float turn);
+
+// CPG-Fußbahnen über LegIK (Umschalten wirkt beim nächsten CPG-Start)
+void setCpgIk(bool enabled, float strideMm);
+
+// Bein-Geometrie für LegIK
+void setLegGeometry(const LegGeometry& geometry);
+
+// Segment-Cache: geplante Segmente der laufenden Gangarten verwerfen
+// (nach Änderungen, die Zielposen, Phasen oder Dauern beeinflussen)
+void invalidateSegmentCache();
+
+struct SegmentCacheStats {
+    uint32_t hits;           // Segment aus dem Cache übernommen
+    uint32_t misses;         // Segment neu geplant
+    uint32_t invalidations;
+};
+const SegmentCacheStats& getSegmentCacheStats();
+
+// Strombudget (gaitConfig.current): Budget in mA, Modell in mA bei 100 Grad/s
+void setCurrentBudget(bool enabled, uint16_t budgetMa);
+void setCurrentModel(uint16_t hipMaPer100Dps, uint16_t kneeMaPer100Dps);
+
+struct CurrentStats {
+    uint16_t cyclePeakMa;        // Geschätzter Spitzenstrom im letzten Zyklus
+    uint16_t cycleAvgMa;         // Geschätzter mittlerer Strom im letzten Zyklus
+    uint32_t cycles;             // Ausgewertete Zyklen
+    uint32_t shiftedLegs;        // Bein-Starts verschoben
+    uint32_t stretchedSegments;  // Segmente gestreckt
+    uint32_t overBudget;         // Segmente auch nach max. Streckung über Budget
+};
+const CurrentStats& getCurrentStats();
+void resetCurrentStats();
+
 // Konfiguration laden/speichern (LittleFS)
 bool saveConfig();
 bool loadConfig();
 
+// Float- gegen Fixed-Point-Pfad vergleichen (Zyklen + max. Winkelabweichung)
+struct BenchmarkResult {
+    uint32_t floatCycles;
+    uint32_t fixedCycles;
+    int maxDiffFine;       // Max. Winkelabweichung in 1/16 Grad
+};
+BenchmarkResult benchmark(const KeyframeTable& table);
+
 } // namespace GaitRuntime
 
 // =============================================================================
 // Interne Helper (für Tests zugänglich)
 // =============================================================================
+// Posen und Winkel in 1/16 Grad, außer den Keyframe-Rohwerten (rawAngle).
+// =============================================================================
 namespace GaitRuntimeInternal {
 
-// Phase-Erkennung basierend auf Lift-Heuristik
+// Phase-Erkennung basierend auf Lift-Heuristik: pro Bein über dessen Knee,
+// detectPhase() = SWING, sobald ein Bein hebt
+GaitPhase detectLegPhase(uint8_t leg, const int fromPose[], const int toPose[]);
 GaitPhase detectPhase(const int fromPose[], const int toPose[]);
 
-// Stride-Skalierung anwenden
+// Stride-Skalierung anwenden (Grad -> 1/16 Grad)
 int applyStrideScale(int rawAngle, uint8_t servoIdx, float effectiveStride);
 
 // Smoothstep Easing
 float smoothstep(float t);
 
+// Fixed-Point Varianten (Q15 Fortschritt, Q16 Faktoren)
+int32_t smoothstepQ15(int32_t tQ15);
+int applyStrideScaleQ16(int rawAngle, uint8_t servoIdx, int32_t strideQ16);
+int32_t toQ16(float value);
+
 // Clamp auf Servo-Limits
 int clampToLimits(int angle, uint8_t servoIdx);
 
+// Waypoint-Puffer für ein Segment füllen (subSteps Stützstellen auf festem Zeitraster)
+// buildWaypoints() wählt je nach GAIT_FIXED_POINT den Float- oder Q15-Pfad.
+// legFinishQ15: Bein erreicht das Ziel nach diesem Anteil des Segments und
+// hält dann (nullptr = alle Beine über das ganze Segment)
+// legStartQ15: Bein hält die Startpose bis zu diesem Anteil (nullptr = sofort)
+void buildWaypoints(const int fromPose[], const int toPose[], uint8_t count,
+                    int16_t waypoints[][8], const uint16_t legFinishQ15[] = nullptr,
+                    const uint16_t legStartQ15[] = nullptr);
+void buildWaypointsFloat(const int fromPose[], const int toPose[], uint8_t count,
+                         int16_t waypoints[][8], const uint16_t legFinishQ15[] = nullptr,
+                         const uint16_t legStartQ15[] = nullptr);
+void buildWaypointsFixed(const int fromPose[], const int toPose[], uint8_t count,
+                         int16_t waypoints[][8], const uint16_t legFinishQ15[] = nullptr,
+                         const uint16_t legStartQ15[] = nullptr);
+
+// Hermite-Spline: Tangenten m0/m1 (1/16 Grad pro Segment) an Start und Ziel
+void buildSplineWaypoints(const int fromPose[], const int toPose[],
+                          const int m0[], const int m1[], uint8_t count,
+                          int16_t waypoints[][8]);
+
 } // namespace GaitRuntimeInternal
 
 #endif // GAIT_RUNTIME_H
@@ -0,0 +1,163 @@
+// =============================================================================
+// LegIK.cpp - Implementierung der Bein-IK
+// =============================================================================
+#include "LegIK.h"
+
+namespace LegIK {
+
+// =============================================================================
+// Lookup-Tabellen
+// =============================================================================
+// atan(i/64) für i = 0..64 in 1/16 Grad
+static const int16_t ATAN_LUT[65] PROGMEM = {
+        0,    14,    29,    43,    57,    71,    86,   100,   114,   128,
+      142,   156,   170,   184,   197,   211,   225,   238,   251,   265,
+      278,   291,   304,   316,   329,   341,   354,   366,   378,   390,
+      402,   414,   425,   436,   448,   459,   470,   481,   491,   502,
+      512,   522,   532,   542,   552,   562,   571,   581,   590,   599,
+      608,   617,   626,   634,   642,   651,   659,   667,   675,   683,
+      690,   698,   705,   713,   720,
+};
+
+// sin(i Grad) für i = 0..90 in Q15
+static const int16_t SIN_LUT[91] PROGMEM = {
+        0,   572,  1144,  1715,  2286,  2856,  3425,  3993,  4560,  5126,
+     5690,  6252,  6813,  7371,  7927,  8481,  9032,  9580, 10126, 10668,
+    11207, 11743, 12275, 12803, 13328, 13848, 14364, 14876, 15383, 15886,
+    16383, 16876, 17364, 17846, 18323, 18794, 19260, 19720, 20173, 20621,
+    21062, 21497, 21925, 22347, 22762, 23170, 23571, 23964, 24351, 24730,
+    25101, 25465, 25821, 26169, 26509, 26841, 27165, 27481, 27788, 28087,
+    28377, 28659, 28932, 29196, 29451, 29697, 29934, 30162, 30381, 30591,
+    30791, 30982, 31163, 31335, 31498, 31650, 31794, 31927, 32051, 32165,
+    32269, 32364, 32448, 32523, 32587, 32642, 32687, 32722, 32747, 32762,
+    32767,
+};
+
+static const int32_t DEG_90_FINE = 90 * ANGLE_FINE_ONE;
+static const int32_t DEG_180_FINE = 180 * ANGLE_FINE_ONE;
+static const int32_t DEG_360_FINE = 360 * ANGLE_FINE_ONE;
+
+// =============================================================================
+// Geometrie (1/16 mm, 1/16 Grad)
+// =============================================================================
+static int32_t coxaFine = 0;
+static int32_t tibiaFine = 0;
+static int32_t neutralTiltFine = 0;
+static int32_t mountFine = 0;
+static int32_t neutralReachFine = 0;
+
+// =============================================================================
+// Helper
+// =============================================================================
+static uint32_t isqrt(uint32_t v) {
+    uint32_t result = 0;
+    uint32_t bit = 1UL << 30;
+    while (bit > v) bit >>= 2;
+    while (bit != 0) {
+        if (v >= result + bit) {
+            v -= result + bit;
+            result = (result >> 1) + bit;
+        } else {
+            result >>= 1;
+        }
+        bit >>= 2;
+    }
+    return result;
+}
+
+// sin für 0 .. 90 Grad mit linearer Interpolation zwischen den Grad-Stützstellen
+static int32_t sinQuarter(int32_t angleFine) {
+    int32_t idx = angleFine >> ANGLE_FINE_SHIFT;
+    int32_t frac = angleFine & (ANGLE_FINE_ONE - 1);
+    int32_t a = (int16_t)pgm_read_word(&SIN_LUT[idx]);
+    if (frac == 0) return a;
+    int32_t b = (int16_t)pgm_read_word(&SIN_LUT[idx + 1]);
+    return a + (((b - a) * frac) >> ANGLE_FINE_SHIFT);
+}
+
+// atan für Verhältnis 0 .. 1 (Q16) in 1/16 Grad
+static int32_t atanUnit(uint32_t ratioQ16) {
+    uint32_t idx = ratioQ16 >> 10;
+    uint32_t frac = ratioQ16 & 1023;
+    int32_t a = (int16_t)pgm_read_word(&ATAN_LUT[idx]);
+    if (frac == 0) return a;
+    int32_t b = (int16_t)pgm_read_word(&ATAN_LUT[idx + 1]);
+    return a + (int32_t)(((b - a) * (int32_t)frac) >> 10);
+}
+
+// =============================================================================
+// Trig
+// =============================================================================
+int32_t sinFine(int32_t angleFine) {
+    int32_t a = angleFine % DEG_360_FINE;
+    if (a < 0) a += DEG_360_FINE;
+
+    if (a <= DEG_90_FINE) return sinQuarter(a);
+    if (a <= DEG_180_FINE) return sinQuarter(DEG_180_FINE - a);
+    if (a <= DEG_180_FINE + DEG_90_FINE) return -sinQuarter(a - DEG_180_FINE);
+    return -sinQuarter(DEG_360_FINE - a);
+}
+
+int32_t cosFine(int32_t angleFine) {
+    return sinFine(angleFine + DEG_90_FINE);
+}
+
+int32_t atan2Fine(int32_t y, int32_t x) {
+    if (x == 0 && y == 0) return 0;
+
+    uint32_t ax = (uint32_t)abs(x);
+    uint32_t ay = (uint32_t)abs(y);
+
+    // Oktant: Verhältnis immer <= 1
+    int32_t a = (ay <= ax)
+        ? atanUnit((ay << 16) / ax)
+        : DEG_90_FINE - atanUnit((ax << 16) / ay);
+
+    if (x < 0) a = DEG_180_FINE - a;
+    return (y < 0) ? -a : a;
+}
+
+// =============================================================================
+// API
+// =============================================================================
+void applyGeometry() {
+    const LegGeometry& g = gaitConfig.leg;
+
+    coxaFine = (int32_t)(g.coxaMm * MM_FINE_ONE);
+    tibiaFine = (int32_t)(g.tibiaMm * MM_FINE_ONE);
+    neutralTiltFine = (int32_t)(g.neutralTiltDeg * ANGLE_FINE_ONE);
+    mountFine = (int32_t)(g.mountDeg * ANGLE_FINE_ONE);
+    neutralReachFine = coxaFine + ((tibiaFine * cosFine(neutralTiltFine)) >> 15);
+}
+
+void neutralFoot(bool frontLeg, int32_t& x, int32_t& y) {
+    int32_t mount = frontLeg ? mountFine : -mountFine;
+    x = (neutralReachFine * sinFine(mount)) >> 15;
+    y = (neutralReachFine * cosFine(mount)) >> 15;
+}
+
+bool solve(bool frontLeg, int32_t x, int32_t y, int32_t& hipFine, int32_t& kneeFine) {
+    bool reachable = true;
+
+    // Hip: Richtung des Fußes, von quer (y) Richtung vorwärts (x) gemessen
+    int32_t mount = frontLeg ? mountFine : -mountFine;
+    hipFine = atan2Fine(x, y) - mount;
+
+    // Knee: Reichweite über Unterschenkel-Neigung, cos(tilt) = (r - coxa) / tibia
+    int32_t reach = (int32_t)isqrt((uint32_t)(x * x + y * y)) - coxaFine;
+    int32_t cosTilt = (reach * Q15_ONE) / tibiaFine;
+    if (cosTilt < 0) {
+        cosTilt = 0;
+        reachable = false;
+    } else if (cosTilt > Q15_ONE) {
+        cosTilt = Q15_ONE;
+        reachable = false;
+    }
+    int32_t sinTilt = (int32_t)isqrt((uint32_t)(Q15_ONE * Q15_ONE - cosTilt * cosTilt));
+    int32_t tilt = atan2Fine(sinTilt, cosTilt);
+
+    kneeFine = neutralTiltFine - tilt;
+    return reachable;
+}
+
+} // namespace LegIK
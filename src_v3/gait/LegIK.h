@@ -0,0 +1,42 @@
+// =============================================================================
+// LegIK.h - Inverse Kinematik für 2-DOF Beine mit Trig-Lookup-Tabellen
+// =============================================================================
+// v3 Gait Runtime Module für ESP8266 Spider Controller
+// Bein-Modell (gaitConfig.leg):
+//   - Hip dreht das Bein in der Horizontalen
+//   - Knee neigt den Unterschenkel unter die Horizontale
+//   - Reichweite r = coxa + tibia * cos(Neigung)
+// Fußziele liegen im Bein-Koordinatensystem: x = vorwärts (Körperlängsachse),
+// y = nach außen. sin/cos/atan2 laufen über PROGMEM-Tabellen (1/16 Grad, Q15),
+// keine Float-Trigonometrie im Tick.
+// =============================================================================
+#ifndef LEG_IK_H
+#define LEG_IK_H
+
+#include <Arduino.h>
+#include "GaitConfig.h"
+
+namespace LegIK {
+
+// Längen in 1/16 mm
+static const int32_t MM_FINE_ONE = 16;
+
+// Geometrie aus gaitConfig.leg übernehmen (nach jeder Änderung aufrufen)
+void applyGeometry();
+
+// Fußposition der Neutralpose (1/16 mm); vordere Beine zeigen nach vorn
+void neutralFoot(bool frontLeg, int32_t& x, int32_t& y);
+
+// Fußziel (1/16 mm) -> Hip-Drehung relativ zur Neutralrichtung (+ = Fuß nach vorn)
+// und Knee-Hub relativ zur Neutralneigung (+ = Unterschenkel flacher), je 1/16 Grad.
+// Rückgabe: false = Ziel außerhalb der Reichweite, Ergebnis an den Rand geklemmt.
+bool solve(bool frontLeg, int32_t x, int32_t y, int32_t& hipFine, int32_t& kneeFine);
+
+// Trig-Helper (Winkel in 1/16 Grad, Werte in Q15)
+int32_t sinFine(int32_t angleFine);
+int32_t cosFine(int32_t angleFine);
+int32_t atan2Fine(int32_t y, int32_t x);
+
+} // namespace LegIK
+
+#endif // LEG_IK_H
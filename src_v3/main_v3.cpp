@@ -12,11 +12,11 @@
 #include <Arduino.h>
 #include <ESP8266WiFi.h>
 #include <LittleFS.h>
-#include <Servo.h>
 
 // v3 Module
 #include "robot/RobotController_v3.h"
 #include "motion/MotionData_v3.h"
+#include "motion/ServoOutput.h"
 #include "gait/GaitRuntime.h"
 #include "calibration/ServoCalibration.h"
 #include "web/WebServer_v3.h"
@@ -51,14 +51,7 @@ void setup() {
     
     // Servos initialisieren
     Serial.println(F("[Servo] Initializing..."));
-    servo_14.attach(14, SERVOMIN, SERVOMAX);
-    servo_12.attach(12, SERVOMIN, SERVOMAX);
-    servo_13.attach(13, SERVOMIN, SERVOMAX);
-    servo_15.attach(15, SERVOMIN, SERVOMAX);
-    servo_16.attach(16, SERVOMIN, SERVOMAX);
-    servo_5.attach(5, SERVOMIN, SERVOMAX);
-    servo_4.attach(4, SERVOMIN, SERVOMAX);
-    servo_2.attach(2, SERVOMIN, SERVOMAX);
+    ServoOutput::begin();
     
     // Servo-Kalibrierung laden
     ServoCalibration::init();
@@ -96,6 +89,9 @@ void setup() {
     // WebServer starten
     setupWebServer();
     
+    // Setup-Pausen (WLAN-Verbindung) nicht als loop-Jitter zählen
+    ServoOutput::resetStats();
+    
     Serial.println(F("\n========================================"));
     Serial.println(F("  Spider Controller v3 - Ready!"));
     Serial.println(F("========================================\n"));
@@ -108,6 +104,12 @@ void loop() {
     // Robot Controller verarbeiten (nicht-blockierend)
     robotController.processQueue();
     
+    // Slew-Limiter: Servos zwischen den Kommandos nachführen
+    servo_slew_tick();
+    
+    // Fertigen Frame für die Ausgabe-ISR veröffentlichen
+    servo_frame_commit();
+    
     // Watchdog füttern
     yield();
 }
@@ -0,0 +1,33 @@
+// =============================================================================
+// Keyframe.cpp - Transformationen für Keyframe-Tabellen
+// =============================================================================
+#include "Keyframe.h"
+
+void transformKeyframePose(uint8_t transform, int pose[]) {
+    if (transform & KEYFRAME_MIRROR_LR) {
+        int source[8];
+        for (int i = 0; i < 8; i++) {
+            source[i] = pose[i];
+        }
+        for (int leg = 0; leg < LEG_COUNT; leg++) {
+            int partner = leg ^ 2;
+            pose[HIP_SERVO_IDX[leg]] = 180 - source[HIP_SERVO_IDX[partner]];
+            pose[KNEE_SERVO_IDX[leg]] = 180 - source[KNEE_SERVO_IDX[partner]];
+        }
+    }
+    
+    if (transform & KEYFRAME_FLIP_HIPS) {
+        for (int leg = 0; leg < LEG_COUNT; leg++) {
+            pose[HIP_SERVO_IDX[leg]] = 180 - pose[HIP_SERVO_IDX[leg]];
+        }
+    }
+}
+
+int readTableKeyframe(const KeyframeTable& table, int step, int pose[]) {
+    int row = keyframeSourceStep(table.steps, table.transform, step);
+    for (int i = 0; i < 8; i++) {
+        pose[i] = keyframeAngle(table.rows, row, i);
+    }
+    transformKeyframePose(table.transform, pose);
+    return keyframeDuration(table.rows, keyframeDurationStep(table.steps, table.transform, step));
+}
@@ -0,0 +1,117 @@
+// =============================================================================
+// Keyframe.h - Gepackte Keyframes und eingebaute Keyframe-Tabellen
+// =============================================================================
+// v3 Motion Module für ESP8266 Spider Controller
+// Ein Keyframe belegt 10 Byte (8 Winkel als uint8 + Dauer als uint16) statt
+// 36 Byte als int[9]. Dasselbe Layout nutzen die Motion-Dateien (MotionFile).
+// Eingebaute Tabellen:
+//   - Zeilen als constexpr-Array in PROGMEM, Schrittzahl aus der Arraygröße
+//   - Winkel > 255 scheitern schon an der Initialisierung (Narrowing)
+//   - keyframesInDefaultLimits() prüft per static_assert gegen die
+//     Default-ServoLimits; geprüfte Tabellen brauchen zur Laufzeit keinen Clamp
+//   - Spiegelungen und Rückwärts-Wiedergabe werden beim Lesen aus einer
+//     Quelltabelle abgeleitet (KEYFRAME_* Transformationen), nicht doppelt
+//     im Flash abgelegt
+// =============================================================================
+#ifndef KEYFRAME_H
+#define KEYFRAME_H
+
+#include <Arduino.h>
+#include "../gait/GaitConfig.h"
+
+struct Keyframe {
+    uint8_t angle[8];        // Grad, Servo-Reihenfolge wie Running_Servo_POS
+    uint16_t durationMs;
+};
+
+static_assert(sizeof(Keyframe) == 10, "Keyframe muss 10 Byte haben");
+
+// Eingebaute Tabelle (Zeilen in PROGMEM)
+struct KeyframeTable {
+    const Keyframe* rows;
+    uint16_t steps;
+    bool inDefaultLimits;    // Alle Winkel beim Kompilieren in den Default-Limits
+    uint8_t transform;       // KEYFRAME_* Bitmaske, beim Lesen angewendet
+};
+
+// =============================================================================
+// Transformationen (Bitmaske)
+// =============================================================================
+// Beinreihenfolge wie HIP_SERVO_IDX/KNEE_SERVO_IDX: UR, LR, UL, LL.
+// Links/Rechts-Partner eines Beins ist daher leg ^ 2 (UR<->UL, LR<->LL).
+static const uint8_t KEYFRAME_MIRROR_LR = 0x01;   // Beine links/rechts tauschen, Winkel 180-x
+static const uint8_t KEYFRAME_FLIP_HIPS = 0x02;   // Hip-Winkel 180-x: Lauf-/Drehrichtung umkehren
+static const uint8_t KEYFRAME_REVERSED  = 0x04;   // Keyframes zeitlich rückwärts abspielen
+
+// 180-x bildet die Default-Limits auf sich selbst ab, geprüfte Tabellen
+// bleiben nach Spiegelung geprüft
+static_assert(SERVO_DEFAULT_MIN_ANGLE + SERVO_DEFAULT_MAX_ANGLE == 180,
+              "Default-ServoLimits müssen symmetrisch um 90 Grad liegen");
+
+// Keyframe-Felder aus PROGMEM lesen
+inline int keyframeAngle(const Keyframe* rows, int step, int servo) {
+    return pgm_read_byte(&rows[step].angle[servo]);
+}
+
+inline int keyframeDuration(const Keyframe* rows, int step) {
+    return pgm_read_word(&rows[step].durationMs);
+}
+
+// Quell-Keyframe für Wiedergabeschritt step (KEYFRAME_REVERSED)
+inline int keyframeSourceStep(int steps, uint8_t transform, int step) {
+    return (transform & KEYFRAME_REVERSED) ? steps - 1 - step : step;
+}
+
+// Keyframe, dessen Dauer für Wiedergabeschritt step gilt. Rückwärts läuft
+// das Segment zu Quellzeile r aus Zeile r+1 heraus, also mit deren Dauer -
+// beide Richtungen brauchen damit gleich lange.
+inline int keyframeDurationStep(int steps, uint8_t transform, int step) {
+    return (transform & KEYFRAME_REVERSED) ? (steps - step) % steps : step;
+}
+
+// KEYFRAME_MIRROR_LR / KEYFRAME_FLIP_HIPS auf eine Pose (Grad) anwenden
+void transformKeyframePose(uint8_t transform, int pose[]);
+
+// Wiedergabeschritt step einer Tabelle inkl. Transformation lesen.
+// pose in Grad, Rückgabe: Dauer in ms
+int readTableKeyframe(const KeyframeTable& table, int step, int pose[]);
+
+// =============================================================================
+// Compile-Zeit-Prüfung
+// =============================================================================
+template <size_t N>
+constexpr bool keyframesInDefaultLimits(const Keyframe (&rows)[N]) {
+    for (size_t step = 0; step < N; step++) {
+        for (size_t servo = 0; servo < 8; servo++) {
+            if (rows[step].angle[servo] < SERVO_DEFAULT_MIN_ANGLE ||
+                rows[step].angle[servo] > SERVO_DEFAULT_MAX_ANGLE) {
+                return false;
+            }
+        }
+    }
+    return true;
+}
+
+template <size_t N>
+constexpr KeyframeTable makeKeyframeTable(const Keyframe (&rows)[N]) {
+    static_assert(N > 0 && N <= 0xFFFF, "Keyframe-Tabelle leer oder zu groß");
+    return KeyframeTable{ rows, (uint16_t)N, keyframesInDefaultLimits(rows), 0 };
+}
+
+// Abgeleitete Tabellen: gleiche Zeilen, nur die Transformation ändert sich
+constexpr KeyframeTable mirroredLeftRight(const KeyframeTable& table) {
+    return KeyframeTable{ table.rows, table.steps, table.inDefaultLimits,
+                          (uint8_t)(table.transform ^ KEYFRAME_MIRROR_LR) };
+}
+
+constexpr KeyframeTable flippedHips(const KeyframeTable& table) {
+    return KeyframeTable{ table.rows, table.steps, table.inDefaultLimits,
+                          (uint8_t)(table.transform ^ KEYFRAME_FLIP_HIPS) };
+}
+
+constexpr KeyframeTable timeReversed(const KeyframeTable& table) {
+    return KeyframeTable{ table.rows, table.steps, table.inDefaultLimits,
+                          (uint8_t)(table.transform ^ KEYFRAME_REVERSED) };
+}
+
+#endif // KEYFRAME_H
@@ -2,29 +2,17 @@
 // MotionData_v3.cpp - Motion-Daten Implementierung für v3
 // =============================================================================
 // Enthält:
-//   - Servo-Objekte
 //   - PROGMEM Keyframe-Matrizen
 //   - Low-level Servo-Control mit Kalibrierungs-Integration
 //   - Terrain-Blending
 //   - Legacy Blocking Engine
 // =============================================================================
 #include "MotionData_v3.h"
+#include "ServoOutput.h"
 #include "../calibration/ServoCalibration.h"
 #include <Arduino.h>
 #include <LittleFS.h>
 
-// =============================================================================
-// Servo-Objekte
-// =============================================================================
-Servo servo_14;  // Index 0 - UR paw
-Servo servo_12;  // Index 1 - UR arm
-Servo servo_13;  // Index 2 - LR arm
-Servo servo_15;  // Index 3 - LR paw
-Servo servo_16;  // Index 4 - UL paw
-Servo servo_5;   // Index 5 - UL arm
-Servo servo_4;   // Index 6 - LL arm
-Servo servo_2;   // Index 7 - LL paw
-
 // =============================================================================
 // Konstanten
 // =============================================================================
@@ -32,8 +20,8 @@ const int PWMRES_Min = 1;
 const int PWMRES_Max = 180;
 const int ALLMATRIX = 9;
 const int ALLSERVOS = 8;
-const int SERVOMIN = 400;
-const int SERVOMAX = 2400;
+const int SERVOMIN = SERVO_PULSE_MIN_US;
+const int SERVOMAX = SERVO_PULSE_MAX_US;
 
 // =============================================================================
 // Globale Variablen
@@ -53,21 +41,28 @@ int terrainBlendTarget = 0;
 const int TERRAIN_OFFSET = 25;
 const int TERRAIN_BLEND_SPEED = 3;
 
+// Output-Cache: zuletzt geschriebene Pulsbreite pro Kanal in µs (-1 = unbekannt)
+static int lastWrittenValue[ALLSERVOS] = { -1, -1, -1, -1, -1, -1, -1, -1 };
+static ServoWriteStats servoWriteStats = ServoWriteStats();
+
+// =============================================================================
+// PROGMEM Keyframe-Tabellen (Werte identisch mit Original, gepackt)
 // =============================================================================
-// PROGMEM Keyframe-Matrizen (identisch mit Original)
+// Schrittzahl kommt aus der Arraygröße. Jede Tabelle wird per static_assert
+// gegen die Default-ServoLimits geprüft, außer sie überschreitet sie bewusst.
 // =============================================================================
 
-const int Servo_Act_0[] PROGMEM = { 90, 90, 90, 90, 90, 90, 90, 90, 500 };
-const int Servo_Act_1[] PROGMEM = { 60, 90, 90, 120, 120, 90, 90, 60, 500 };
+static constexpr Keyframe Servo_Act_0 PROGMEM = { 90, 90, 90, 90, 90, 90, 90, 90, 500 };
+static constexpr Keyframe Servo_Act_1 PROGMEM = { 60, 90, 90, 120, 120, 90, 90, 60, 500 };
 
-const int Servo_Prg_1_Step = 2;
-const int Servo_Prg_1[][ALLMATRIX] PROGMEM = {
+static constexpr Keyframe Servo_Prg_1_Rows[] PROGMEM = {
     { 90, 90, 90, 90, 90, 90, 90, 90, 500 },
     { 60, 90, 90, 120, 120, 90, 90, 60, 500 },
 };
+const KeyframeTable Servo_Prg_1 = makeKeyframeTable(Servo_Prg_1_Rows);
+static_assert(keyframesInDefaultLimits(Servo_Prg_1_Rows), "Servo_Prg_1: Winkel außerhalb der Default-ServoLimits");
 
-const int Servo_Prg_2_Step = 11;
-const int Servo_Prg_2[][ALLMATRIX] PROGMEM = {
+static constexpr Keyframe Servo_Prg_2_Rows[] PROGMEM = {
     {  78,  90,  90, 106, 106,  90,  90,  78, 220 },
     {  86,  94,  90, 110, 110,  90,  86,  86, 170 },
     {  90, 108,  90, 110, 110,  90,  72,  90, 140 },
@@ -80,24 +75,13 @@ const int Servo_Prg_2[][ALLMATRIX] PROGMEM = {
     {  90,  90, 108, 110, 110,  72,  90,  90, 170 },
     {  78,  90,  90, 106, 106,  90,  90,  78, 220 },
 };
+const KeyframeTable Servo_Prg_2 = makeKeyframeTable(Servo_Prg_2_Rows);
+static_assert(keyframesInDefaultLimits(Servo_Prg_2_Rows), "Servo_Prg_2: Winkel außerhalb der Default-ServoLimits");
 
-const int Servo_Prg_3_Step = 11;
-const int Servo_Prg_3[][ALLMATRIX] PROGMEM = {
-    {  78,  90,  90, 106, 106,  90,  90,  78, 220 },
-    {  86,  86,  90, 110, 110,  90,  94,  86, 170 },
-    {  90,  72,  90, 110, 110,  90, 108,  90, 140 },
-    {  82,  62,  90, 110, 110,  90, 118,  82, 130 },
-    {  74,  60,  90,  98,  98,  90, 120,  74, 160 },
-    {  72,  78,  90,  90,  90,  90, 102,  72, 220 },
-    {  72,  90,  72,  90,  90, 108,  90,  72, 160 },
-    {  72,  90,  62, 102, 102, 118,  90,  72, 130 },
-    {  86,  90,  60, 110, 110, 120,  90,  86, 140 },
-    {  90,  90,  72, 110, 110, 108,  90,  90, 170 },
-    {  78,  90,  90, 106, 106,  90,  90,  78, 220 },
-};
+// Servo_Prg_3 = Prg_2 mit gespiegelten Hips (180-x): gleiche Schrittfolge rückwärts
+const KeyframeTable Servo_Prg_3 = flippedHips(makeKeyframeTable(Servo_Prg_2_Rows));
 
-const int Servo_Prg_4_Step = 11;
-const int Servo_Prg_4[][ALLMATRIX] PROGMEM = {
+static constexpr Keyframe Servo_Prg_4_Rows[] PROGMEM = {
     {  78,  90,  90, 106, 106,  90,  90,  78, 230 },
     {  74,  90,  90,  96,  96,  90,  90,  74, 190 },
     {  72,  90,  72,  96,  96, 108,  90,  72, 160 },
@@ -110,26 +94,14 @@ const int Servo_Prg_4[][ALLMATRIX] PROGMEM = {
     {  72, 102,  90,  90,  90,  90,  78,  72, 220 },
     {  78,  90,  90, 106, 106,  90,  90,  78, 230 },
 };
+const KeyframeTable Servo_Prg_4 = makeKeyframeTable(Servo_Prg_4_Rows);
+static_assert(keyframesInDefaultLimits(Servo_Prg_4_Rows), "Servo_Prg_4: Winkel außerhalb der Default-ServoLimits");
 
 // Servo_Prg_5 = Gespiegelte Version von Prg_4 (Links→Rechts)
-// Swap: [s4,s5,s6,s7] ↔ [s0,s1,s2,s3] + Winkel spiegeln (180-x)
-const int Servo_Prg_5_Step = 11;
-const int Servo_Prg_5[][ALLMATRIX] PROGMEM = {
-    {  74,  90,  90, 102, 102,  90,  90,  74, 230 },
-    {  84,  90,  90, 106, 106,  90,  90,  84, 190 },
-    {  84,  72,  90, 108, 108,  90, 108,  84, 160 },
-    {  74,  62,  90, 108, 108,  90, 118,  74, 140 },
-    {  70,  60,  90,  94,  94,  90, 120,  70, 150 },
-    {  70,  78,  90,  90,  90,  90, 102,  70, 220 },
-    {  70,  90, 108,  90,  90,  72,  90,  70, 160 },
-    {  70,  90, 118,  98,  98,  62,  90,  70, 140 },
-    {  82,  90, 120, 106, 106,  60,  90,  82, 150 },
-    {  90,  90, 102, 108, 108,  78,  90,  90, 220 },
-    {  74,  90,  90, 102, 102,  90,  90,  74, 230 },
-};
+// Swap: [s4,s5,s6,s7] ↔ [s0,s1,s2,s3] + Winkel spiegeln (180-x), beim Lesen
+const KeyframeTable Servo_Prg_5 = mirroredLeftRight(makeKeyframeTable(Servo_Prg_4_Rows));
 
-const int Servo_Prg_6_Step = 8;
-const int Servo_Prg_6[][ALLMATRIX] PROGMEM = {
+static constexpr Keyframe Servo_Prg_6_Rows[] PROGMEM = {
     {  78,  90,  90, 106, 106,  90,  90,  78, 220 },
     {  86,  96,  90, 110, 110,  90,  96,  86, 160 },
     {  90, 118,  90, 110, 110,  90, 118,  90, 140 },
@@ -139,26 +111,19 @@ const int Servo_Prg_6[][ALLMATRIX] PROGMEM = {
     {  72, 118, 132, 106, 106, 132, 118,  72, 160 },
     {  78,  90,  90, 106, 106,  90,  90,  78, 220 },
 };
+const KeyframeTable Servo_Prg_6 = makeKeyframeTable(Servo_Prg_6_Rows);
+static_assert(keyframesInDefaultLimits(Servo_Prg_6_Rows), "Servo_Prg_6: Winkel außerhalb der Default-ServoLimits");
 
-const int Servo_Prg_7_Step = 8;
-const int Servo_Prg_7[][ALLMATRIX] PROGMEM = {
-    {  78,  90,  90, 106, 106,  90,  90,  78, 220 },
-    {  74,  90,  90,  98,  98,  90,  90,  74, 160 },
-    {  72,  90,  62,  98,  98,  62,  90,  72, 140 },
-    {  72,  90,  50, 110, 110,  50,  90,  72, 130 },
-    {  86,  90,  45, 110, 110,  45,  90,  86, 170 },
-    {  90,  62,  50, 110, 110,  50,  62,  90, 200 },
-    {  82,  50,  62, 110, 110,  62,  50,  82, 160 },
-    {  78,  90,  90, 106, 106,  90,  90,  78, 220 },
-};
+// Servo_Prg_7 = Prg_6 mit gespiegelten Hips: Rechtsdrehung, gleich schnell wie links
+const KeyframeTable Servo_Prg_7 = flippedHips(makeKeyframeTable(Servo_Prg_6_Rows));
 
-const int Servo_Prg_8_Step = 1;
-const int Servo_Prg_8[][ALLMATRIX] PROGMEM = {
+static constexpr Keyframe Servo_Prg_8_Rows[] PROGMEM = {
     { 110, 90, 90, 70, 70, 90, 90, 110, 500 },
 };
+const KeyframeTable Servo_Prg_8 = makeKeyframeTable(Servo_Prg_8_Rows);
+static_assert(keyframesInDefaultLimits(Servo_Prg_8_Rows), "Servo_Prg_8: Winkel außerhalb der Default-ServoLimits");
 
-const int Servo_Prg_9_Step = 7;
-const int Servo_Prg_9[][ALLMATRIX] PROGMEM = {
+static constexpr Keyframe Servo_Prg_9_Rows[] PROGMEM = {
     { 70, 90, 135, 90, 90, 90, 90, 90, 400 },
     { 170, 90, 135, 90, 90, 90, 90, 90, 400 },
     { 170, 130, 135, 90, 90, 90, 90, 90, 400 },
@@ -167,9 +132,10 @@ const int Servo_Prg_9[][ALLMATRIX] PROGMEM = {
     { 170, 90, 135, 90, 90, 90, 90, 90, 400 },
     { 70, 90, 135, 90, 90, 90, 90, 90, 400 },
 };
+// Winkt bis 170 Grad, über SERVO_DEFAULT_MAX_ANGLE: bleibt zur Laufzeit geclampt
+const KeyframeTable Servo_Prg_9 = makeKeyframeTable(Servo_Prg_9_Rows);
 
-const int Servo_Prg_10_Step = 11;
-const int Servo_Prg_10[][ALLMATRIX] PROGMEM = {
+static constexpr Keyframe Servo_Prg_10_Rows[] PROGMEM = {
     { 120, 90, 90, 110, 60, 90, 90, 70, 500 },
     { 120, 70, 70, 110, 60, 70, 70, 70, 500 },
     { 120, 110, 110, 110, 60, 110, 110, 70, 500 },
@@ -182,9 +148,10 @@ const int Servo_Prg_10[][ALLMATRIX] PROGMEM = {
     { 70, 110, 110, 70, 110, 110, 110, 110, 500 },
     { 70, 90, 90, 70, 110, 90, 90, 110, 500 },
 };
+const KeyframeTable Servo_Prg_10 = makeKeyframeTable(Servo_Prg_10_Rows);
+static_assert(keyframesInDefaultLimits(Servo_Prg_10_Rows), "Servo_Prg_10: Winkel außerhalb der Default-ServoLimits");
 
-const int Servo_Prg_11_Step = 7;
-const int Servo_Prg_11[][ALLMATRIX] PROGMEM = {
+static constexpr Keyframe Servo_Prg_11_Rows[] PROGMEM = {
     { 70, 90, 90, 110, 110, 90, 90, 70, 100 },
     { 90, 90, 90, 90, 90, 90, 90, 90, 600 },
     { 70, 90, 90, 110, 110, 90, 90, 70, 500 },
@@ -193,15 +160,17 @@ const int Servo_Prg_11[][ALLMATRIX] PROGMEM = {
     { 90, 90, 90, 90, 90, 90, 90, 100, 800 },
     { 70, 90, 90, 110, 110, 90, 90, 70, 500 },
 };
+const KeyframeTable Servo_Prg_11 = makeKeyframeTable(Servo_Prg_11_Rows);
+static_assert(keyframesInDefaultLimits(Servo_Prg_11_Rows), "Servo_Prg_11: Winkel außerhalb der Default-ServoLimits");
 
-const int Servo_Prg_12_Step = 2;
-const int Servo_Prg_12[][ALLMATRIX] PROGMEM = {
+static constexpr Keyframe Servo_Prg_12_Rows[] PROGMEM = {
     { 30, 90, 90, 150, 150, 90, 90, 30, 500 },
     { 30, 45, 135, 150, 150, 135, 45, 30, 500 },
 };
+const KeyframeTable Servo_Prg_12 = makeKeyframeTable(Servo_Prg_12_Rows);
+static_assert(keyframesInDefaultLimits(Servo_Prg_12_Rows), "Servo_Prg_12: Winkel außerhalb der Default-ServoLimits");
 
-const int Servo_Prg_13_Step = 10;
-const int Servo_Prg_13[][ALLMATRIX] PROGMEM = {
+static constexpr Keyframe Servo_Prg_13_Rows[] PROGMEM = {
     { 90, 90, 90, 90, 90, 90, 90, 90, 400 },
     { 50, 90, 90, 90, 90, 90, 90, 90, 400 },
     { 90, 90, 90, 130, 90, 90, 90, 90, 400 },
@@ -213,9 +182,10 @@ const int Servo_Prg_13[][ALLMATRIX] PROGMEM = {
     { 90, 90, 90, 90, 130, 90, 90, 90, 400 },
     { 90, 90, 90, 90, 90, 90, 90, 90, 400 },
 };
+const KeyframeTable Servo_Prg_13 = makeKeyframeTable(Servo_Prg_13_Rows);
+static_assert(keyframesInDefaultLimits(Servo_Prg_13_Rows), "Servo_Prg_13: Winkel außerhalb der Default-ServoLimits");
 
-const int Servo_Prg_14_Step = 9;
-const int Servo_Prg_14[][ALLMATRIX] PROGMEM = {
+static constexpr Keyframe Servo_Prg_14_Rows[] PROGMEM = {
     { 70, 45, 135, 110, 110, 135, 45, 70, 400 },
     { 115, 45, 135, 65, 110, 135, 45, 70, 400 },
     { 70, 45, 135, 110, 65, 135, 45, 115, 400 },
@@ -226,9 +196,10 @@ const int Servo_Prg_14[][ALLMATRIX] PROGMEM = {
     { 115, 45, 135, 65, 110, 135, 45, 70, 400 },
     { 75, 45, 135, 105, 110, 135, 45, 70, 400 },
 };
+const KeyframeTable Servo_Prg_14 = makeKeyframeTable(Servo_Prg_14_Rows);
+static_assert(keyframesInDefaultLimits(Servo_Prg_14_Rows), "Servo_Prg_14: Winkel außerhalb der Default-ServoLimits");
 
-const int Servo_Prg_15_Step = 10;
-const int Servo_Prg_15[][ALLMATRIX] PROGMEM = {
+static constexpr Keyframe Servo_Prg_15_Rows[] PROGMEM = {
     { 70, 45, 45, 110, 110, 135, 135, 70, 400 },
     { 110, 45, 45, 60, 70, 135, 135, 70, 400 },
     { 70, 45, 45, 110, 110, 135, 135, 70, 400 },
@@ -240,6 +211,8 @@ const int Servo_Prg_15[][ALLMATRIX] PROGMEM = {
     { 70, 45, 45, 110, 110, 135, 135, 70, 400 },
     { 70, 90, 90, 110, 110, 90, 90, 70, 400 },
 };
+const KeyframeTable Servo_Prg_15 = makeKeyframeTable(Servo_Prg_15_Rows);
+static_assert(keyframesInDefaultLimits(Servo_Prg_15_Rows), "Servo_Prg_15: Winkel außerhalb der Default-ServoLimits");
 
 // =============================================================================
 // Speed-Funktionen
@@ -309,37 +282,180 @@ int getTerrainAdjustment(int iServo) {
 // Servo-Control (Low-Level) mit Kalibrierungs-Integration
 // =============================================================================
 void Set_PWM_to_Servo(int iServo, int iValue) {
-    if (iServo < 0 || iServo >= ALLSERVOS) return;
+    Set_PWM_to_Servo_Fine(iServo, degToFine(iValue));
+}
+
+// Winkel (1/16 Grad) an die Hardware ausgeben. Offset, Limits und
+// PWM-Sicherheitsbereich stecken in der Ausgabetabelle der Kalibrierung.
+static void writeServoFine(int iServo, int fineAngle) {
+    int pulseUs = ServoCalibration::fineToPulseUs(iServo, fineAngle);
+    
+    // Unveränderten Wert nicht erneut schreiben
+    if (lastWrittenValue[iServo] == pulseUs) {
+        servoWriteStats.skipped++;
+        return;
+    }
+    lastWrittenValue[iServo] = pulseUs;
+    servoWriteStats.issued++;
+    
+    // Servo ansteuern (mit Frame-ISR erst nach servo_frame_commit())
+    ServoOutput::setPulseUs(iServo, pulseUs);
+}
+
+void servo_frame_commit() {
+    ServoOutput::commit();
+}
+
+// =============================================================================
+// Slew-Limiter
+// =============================================================================
+// Position und Geschwindigkeit in 1/16 Grad als Q16, Zeitschritt 1 ms.
+// Wunschgeschwindigkeit = min(maxVelocity, sqrt(2 * maxAccel * Restweg)),
+// damit der Servo vor dem Ziel mit maxAccel abbremst statt zu überschwingen.
+// =============================================================================
+struct SlewState {
+    int32_t posQ16;          // Ausgegebene Position
+    int32_t velQ16;          // pro ms
+    int32_t targetQ16;
+    unsigned long lastMs;
+    bool known;              // Position bekannt (erstes Kommando geht direkt raus)
+};
+
+static SlewState slewState[ALLSERVOS];
+static const unsigned long SLEW_MAX_DT_MS = 20;
+
+static uint32_t isqrt64(uint64_t v) {
+    uint64_t result = 0;
+    uint64_t bit = 1ULL << 62;
+    while (bit > v) bit >>= 2;
+    while (bit != 0) {
+        if (v >= result + bit) {
+            v -= result + bit;
+            result = (result >> 1) + bit;
+        } else {
+            result >>= 1;
+        }
+        bit >>= 2;
+    }
+    return (uint32_t)result;
+}
+
+// Servo iServo bis nowMs nachführen und ausgeben
+static void slewUpdate(int iServo, unsigned long nowMs) {
+    SlewState& st = slewState[iServo];
+    unsigned long dt = nowMs - st.lastMs;
+    if (dt == 0) return;
+    st.lastMs = nowMs;
+    
+    int32_t err = st.targetQ16 - st.posQ16;
+    if (err == 0 && st.velQ16 == 0) return;
+    if (dt > SLEW_MAX_DT_MS) dt = SLEW_MAX_DT_MS;
+    
+    // Grenzen in Q16 (1/16 Grad) pro ms bzw. ms²
+    const int32_t vMax = (int32_t)(((uint32_t)gaitConfig.slew.maxVelocity[iServo] * ANGLE_FINE_ONE << 16) / 1000);
+    const int32_t aMax = (int32_t)(((uint64_t)gaitConfig.slew.maxAccel[iServo] * ANGLE_FINE_ONE << 16) / 1000000);
+    
+    uint32_t distance = err < 0 ? -err : err;
+    int32_t vWant = (int32_t)isqrt64(2ULL * (uint64_t)aMax * distance);
+    bool velocityLimited = vWant > vMax;
+    if (velocityLimited) vWant = vMax;
+    if (err < 0) vWant = -vWant;
     
-    // Kalibrierungs-Offset anwenden
-    int calibratedValue = ServoCalibration::applyOffset(iServo, iValue);
+    int32_t dvMax = aMax * (int32_t)dt;
+    int32_t dv = vWant - st.velQ16;
+    bool accelLimited = dv > dvMax || dv < -dvMax;
+    if (dv > dvMax) dv = dvMax;
+    if (dv < -dvMax) dv = -dvMax;
+    st.velQ16 += dv;
     
-    // Auf Limits clampen
-    calibratedValue = ServoCalibration::clampToLimits(iServo, calibratedValue);
+    int32_t step = st.velQ16 * (int32_t)dt;
+    if ((err >= 0 && step >= err) || (err <= 0 && step <= err)) {
+        // Ziel in diesem Schritt erreicht
+        st.posQ16 = st.targetQ16;
+        st.velQ16 = err / (int32_t)dt;
+    } else {
+        st.posQ16 += step;
+    }
+    
+    servoWriteStats.slewSteps++;
+    if (velocityLimited && (st.velQ16 == vMax || st.velQ16 == -vMax)) {
+        servoWriteStats.velocityLimited++;
+        servoWriteStats.limited[iServo]++;
+    } else if (accelLimited) {
+        servoWriteStats.accelLimited++;
+        servoWriteStats.limited[iServo]++;
+    }
+    
+    writeServoFine(iServo, (st.posQ16 + (1L << 15)) >> 16);
+}
+
+void servo_slew_tick() {
+    if (!gaitConfig.slew.enabled) return;
+    unsigned long nowMs = millis();
+    for (int i = 0; i < ALLSERVOS; i++) {
+        if (slewState[i].known) slewUpdate(i, nowMs);
+    }
+}
+
+bool servoSlewSettled() {
+    if (!gaitConfig.slew.enabled) return true;
+    for (int i = 0; i < ALLSERVOS; i++) {
+        const SlewState& st = slewState[i];
+        if (st.known && (st.posQ16 != st.targetQ16 || st.velQ16 != 0)) return false;
+    }
+    return true;
+}
+
+void servoSlewSettle(unsigned long timeoutMs) {
+    unsigned long start = millis();
+    while (!servoSlewSettled() && millis() - start < timeoutMs) {
+        servo_slew_tick();
+        servo_frame_commit();
+        delay(1);
+    }
+}
+
+void Set_PWM_to_Servo_Fine(int iServo, int fineAngle) {
+    if (iServo < 0 || iServo >= ALLSERVOS) return;
     
-    // Finale Safety-Clamp auf PWM-Bereich
-    if (calibratedValue < PWMRES_Min) calibratedValue = PWMRES_Min;
-    if (calibratedValue > PWMRES_Max) calibratedValue = PWMRES_Max;
+    SlewState& st = slewState[iServo];
+    unsigned long nowMs = millis();
+    if (!gaitConfig.slew.enabled || !st.known) {
+        // Ohne Limiter bzw. beim ersten Kommando direkt ausgeben
+        st.posQ16 = st.targetQ16 = (int32_t)fineAngle << 16;
+        st.velQ16 = 0;
+        st.lastMs = nowMs;
+        st.known = true;
+        writeServoFine(iServo, fineAngle);
+        return;
+    }
     
-    // Servo ansteuern
-    switch (iServo) {
-        case 0: servo_14.write(calibratedValue); break;
-        case 1: servo_12.write(calibratedValue); break;
-        case 2: servo_13.write(calibratedValue); break;
-        case 3: servo_15.write(calibratedValue); break;
-        case 4: servo_16.write(calibratedValue); break;
-        case 5: servo_5.write(calibratedValue); break;
-        case 6: servo_4.write(calibratedValue); break;
-        case 7: servo_2.write(calibratedValue); break;
+    // Bis jetzt mit dem alten Ziel nachführen, dann neues Ziel übernehmen
+    slewUpdate(iServo, nowMs);
+    st.targetQ16 = (int32_t)fineAngle << 16;
+}
+
+const ServoWriteStats& getServoWriteStats() {
+    return servoWriteStats;
+}
+
+void resetServoWriteStats() {
+    servoWriteStats = ServoWriteStats();
+}
+
+void invalidateServoOutputCache() {
+    for (int i = 0; i < ALLSERVOS; i++) {
+        lastWrittenValue[i] = -1;
     }
 }
 
 // =============================================================================
 // Legacy Blocking Motion Engine
 // =============================================================================
-void Servo_PROGRAM_Run(const int iMatrix[][ALLMATRIX], int iSteps) {
-    for (int MainLoopIndex = 0; MainLoopIndex < iSteps; MainLoopIndex++) {
-        int originalTime = pgm_read_word(&iMatrix[MainLoopIndex][ALLMATRIX - 1]);
+void Servo_PROGRAM_Run(const KeyframeTable& table) {
+    int targetPose[SERVO_COUNT];
+    for (int MainLoopIndex = 0; MainLoopIndex < table.steps; MainLoopIndex++) {
+        int originalTime = readTableKeyframe(table, MainLoopIndex, targetPose);
         int timePercent = (110 - speedMultiplier) / 3;
         if (timePercent < 5) timePercent = 5;
         int InterTotalTime = (originalTime * timePercent) / 100;
@@ -354,7 +470,7 @@ void Servo_PROGRAM_Run(const int iMatrix[][ALLMATRIX], int iSteps) {
 
             for (int ServoIndex = 0; ServoIndex < ALLSERVOS; ServoIndex++) {
                 int start = Running_Servo_POS[ServoIndex];
-                int target = pgm_read_word(&iMatrix[MainLoopIndex][ServoIndex]);
+                int target = targetPose[ServoIndex];
 
                 if (start == target) continue;
 
@@ -363,102 +479,151 @@ void Servo_PROGRAM_Run(const int iMatrix[][ALLMATRIX], int iSteps) {
                 int value = (target > start) ? (start + moved) : (start - moved);
                 Set_PWM_to_Servo(ServoIndex, value);
             }
+            // Auch Servos ohne neues Ziel laufen im Slew weiter
+            servo_slew_tick();
+            servo_frame_commit();
 
             delay(BASEDELAYTIME);
             yield();
         }
 
         for (int ServoIndex = 0; ServoIndex < ALLSERVOS; ServoIndex++) {
-            int target = pgm_read_word(&iMatrix[MainLoopIndex][ServoIndex]);
+            int target = targetPose[ServoIndex];
             Set_PWM_to_Servo(ServoIndex, target);
+            Running_Servo_POS[ServoIndex] = target;
         }
+        servo_slew_tick();
+        servo_frame_commit();
+        Running_Servo_POS[ALLMATRIX - 1] = originalTime;
+    }
+}
 
-        for (int Index = 0; Index < ALLMATRIX; Index++) {
-            Running_Servo_POS[Index] = pgm_read_word(&iMatrix[MainLoopIndex][Index]);
+// Strombudget beim Einschalten: laufende Bewegungen (Ende, Strom) je Servo
+struct BootMove {
+    unsigned long endMs;
+    uint16_t currentMa;
+};
+static BootMove bootMoves[ALLSERVOS];
+static const unsigned long BOOT_MOVE_WAIT_MAX_MS = 1000;
+
+// Start von iServo verzögern, bis sein Strom neben den laufenden Bewegungen
+// ins Budget passt. Dauer und Strom aus Weg und Geschwindigkeit: mit
+// Slew-Limiter dessen maxVelocity, sonst fährt der Servo ungebremst.
+static void bootMoveStart(int iServo, uint32_t deltaFine) {
+    uint32_t dps = SERVO_UNLIMITED_DPS;
+    if (gaitConfig.slew.enabled && slewState[iServo].known &&
+        gaitConfig.slew.maxVelocity[iServo] < dps) {
+        dps = gaitConfig.slew.maxVelocity[iServo];
+    }
+    uint32_t durationUs = deltaFine * 1000000 / (dps * ANGLE_FINE_ONE);
+    uint16_t currentMa = (uint16_t)estimateCurrentMa(iServo, deltaFine, durationUs);
+    
+    const CurrentConfig& cfg = gaitConfig.current;
+    unsigned long start = millis();
+    while (cfg.enabled && millis() - start < BOOT_MOVE_WAIT_MAX_MS) {
+        unsigned long nowMs = millis();
+        uint32_t running = currentMa;
+        for (int i = 0; i < ALLSERVOS; i++) {
+            if ((long)(bootMoves[i].endMs - nowMs) > 0) running += bootMoves[i].currentMa;
         }
+        // Ein einzelner Servo über Budget startet trotzdem (allein)
+        if (running <= cfg.budgetMa || running == currentMa) break;
+        servo_slew_tick();
+        servo_frame_commit();
+        delay(1);
     }
+    
+    bootMoves[iServo].endMs = millis() + durationUs / 1000;
+    bootMoves[iServo].currentMa = currentMa;
 }
 
 void Servo_PROGRAM_Zero() {
-    for (int Index = 0; Index < ALLMATRIX; Index++) {
-        Running_Servo_POS[Index] = pgm_read_word(&Servo_Act_0[Index]);
+    // Startposition unbekannt: bis zu 90 Grad Weg annehmen
+    for (int iServo = 0; iServo < ALLSERVOS; iServo++) {
+        bootMoves[iServo].endMs = millis();
+        bootMoves[iServo].currentMa = 0;
     }
     for (int iServo = 0; iServo < ALLSERVOS; iServo++) {
+        Running_Servo_POS[iServo] = keyframeAngle(&Servo_Act_0, 0, iServo);
+        bootMoveStart(iServo, degToFine(90));
         Set_PWM_to_Servo(iServo, Running_Servo_POS[iServo]);
+        servo_frame_commit();
         delay(10);
     }
-    for (int Index = 0; Index < ALLMATRIX; Index++) {
-        Running_Servo_POS[Index] = pgm_read_word(&Servo_Act_1[Index]);
-    }
     for (int iServo = 0; iServo < ALLSERVOS; iServo++) {
+        int from = Running_Servo_POS[iServo];
+        Running_Servo_POS[iServo] = keyframeAngle(&Servo_Act_1, 0, iServo);
+        bootMoveStart(iServo, degToFine(abs(Running_Servo_POS[iServo] - from)));
         Set_PWM_to_Servo(iServo, Running_Servo_POS[iServo]);
+        servo_frame_commit();
         delay(10);
     }
+    Running_Servo_POS[ALLMATRIX - 1] = keyframeDuration(&Servo_Act_1, 0);
 }
 
 // =============================================================================
 // Blockierende Bewegungsfunktionen
 // =============================================================================
 void standby() {
-    Servo_PROGRAM_Run(Servo_Prg_1, Servo_Prg_1_Step);
+    Servo_PROGRAM_Run(Servo_Prg_1);
 }
 
 void sleep() {
-    Servo_PROGRAM_Run(Servo_Prg_1, Servo_Prg_1_Step);
-    Servo_PROGRAM_Run(Servo_Prg_12, Servo_Prg_12_Step);
+    Servo_PROGRAM_Run(Servo_Prg_1);
+    Servo_PROGRAM_Run(Servo_Prg_12);
 }
 
 void lie() {
-    Servo_PROGRAM_Run(Servo_Prg_8, Servo_Prg_8_Step);
+    Servo_PROGRAM_Run(Servo_Prg_8);
 }
 
 void forward_blocking() {
-    Servo_PROGRAM_Run(Servo_Prg_2, Servo_Prg_2_Step);
+    Servo_PROGRAM_Run(Servo_Prg_2);
 }
 
 void back_blocking() {
-    Servo_PROGRAM_Run(Servo_Prg_3, Servo_Prg_3_Step);
+    Servo_PROGRAM_Run(Servo_Prg_3);
 }
 
 void turnleft_blocking() {
-    Servo_PROGRAM_Run(Servo_Prg_6, Servo_Prg_6_Step);
+    Servo_PROGRAM_Run(Servo_Prg_6);
 }
 
 void turnright_blocking() {
-    Servo_PROGRAM_Run(Servo_Prg_7, Servo_Prg_7_Step);
+    Servo_PROGRAM_Run(Servo_Prg_7);
 }
 
 void leftmove_blocking() {
-    Servo_PROGRAM_Run(Servo_Prg_4, Servo_Prg_4_Step);
+    Servo_PROGRAM_Run(Servo_Prg_4);
 }
 
 void rightmove_blocking() {
-    Servo_PROGRAM_Run(Servo_Prg_5, Servo_Prg_5_Step);
+    Servo_PROGRAM_Run(Servo_Prg_5);
 }
 
 void hello() {
-    Servo_PROGRAM_Run(Servo_Prg_9, Servo_Prg_9_Step);
-    Servo_PROGRAM_Run(Servo_Prg_1, Servo_Prg_1_Step);
+    Servo_PROGRAM_Run(Servo_Prg_9);
+    Servo_PROGRAM_Run(Servo_Prg_1);
 }
 
 void dance1() {
-    Servo_PROGRAM_Run(Servo_Prg_13, Servo_Prg_13_Step);
+    Servo_PROGRAM_Run(Servo_Prg_13);
 }
 
 void dance2() {
-    Servo_PROGRAM_Run(Servo_Prg_14, Servo_Prg_14_Step);
+    Servo_PROGRAM_Run(Servo_Prg_14);
 }
 
 void dance3() {
-    Servo_PROGRAM_Run(Servo_Prg_15, Servo_Prg_15_Step);
+    Servo_PROGRAM_Run(Servo_Prg_15);
 }
 
 void pushup() {
-    Servo_PROGRAM_Run(Servo_Prg_11, Servo_Prg_11_Step);
+    Servo_PROGRAM_Run(Servo_Prg_11);
 }
 
 void fighting() {
-    Servo_PROGRAM_Run(Servo_Prg_10, Servo_Prg_10_Step);
+    Servo_PROGRAM_Run(Servo_Prg_10);
 }
 
 void calibpose() {
@@ -6,20 +6,8 @@
 #ifndef MOTION_DATA_V3_H
 #define MOTION_DATA_V3_H
 
-#include <Servo.h>
 #include "../gait/GaitConfig.h"
-
-// =============================================================================
-// Servo-Objekte (extern, definiert in MotionData_v3.cpp)
-// =============================================================================
-extern Servo servo_14;
-extern Servo servo_12;
-extern Servo servo_13;
-extern Servo servo_15;
-extern Servo servo_16;
-extern Servo servo_5;
-extern Servo servo_4;
-extern Servo servo_2;
+#include "Keyframe.h"
 
 // =============================================================================
 // Konstanten
@@ -75,10 +63,41 @@ int getSpeed();
 // =============================================================================
 void Set_PWM_to_Servo(int iServo, int iValue);
 
+// Sub-Grad-Ausgabe: Winkel in 1/16 Grad -> Pulsbreite (ServoOutput)
+void Set_PWM_to_Servo_Fine(int iServo, int fineAngle);
+
+// Geschriebene Pulsbreiten als ganzen Frame an die Ausgabe übergeben
+// (loop() und blockierende Abläufe vor jedem delay())
+void servo_frame_commit();
+
+// Output-Cache: Servo::write() nur bei geändertem Ausgabewert
+struct ServoWriteStats {
+    uint32_t issued;            // Tatsächlich an die Hardware geschrieben
+    uint32_t skipped;           // Wegen unverändertem Wert übersprungen
+    uint32_t slewSteps;         // Slew-Limiter: Schritte mit Bewegung
+    uint32_t velocityLimited;   // davon an maxVelocity begrenzt
+    uint32_t accelLimited;      // davon an maxAccel begrenzt
+    uint32_t limited[8];        // begrenzte Schritte pro Servo
+};
+const ServoWriteStats& getServoWriteStats();
+void resetServoWriteStats();
+void invalidateServoOutputCache();
+
+// =============================================================================
+// Slew-Limiter (gaitConfig.slew)
+// =============================================================================
+// Set_PWM_to_Servo_Fine() setzt das Ziel, der Ausgang folgt mit begrenzter
+// Geschwindigkeit und Beschleunigung (Bremsweg zum Ziel eingerechnet).
+// servo_slew_tick() führt den Ausgang zwischen den Kommandos nach (loop()).
+void servo_slew_tick();
+bool servoSlewSettled();
+// Blockierend warten, bis alle Servos am Ziel sind (max. timeoutMs)
+void servoSlewSettle(unsigned long timeoutMs);
+
 // =============================================================================
 // Legacy Blocking Motion Engine (für Dance/Hello etc.)
 // =============================================================================
-void Servo_PROGRAM_Run(const int iMatrix[][9], int iSteps);
+void Servo_PROGRAM_Run(const KeyframeTable& table);
 void Servo_PROGRAM_Zero();
 
 // =============================================================================
@@ -102,37 +121,22 @@ void fighting();
 void calibpose();
 
 // =============================================================================
-// Bewegungsmatrizen (PROGMEM)
-// =============================================================================
-extern const int Servo_Prg_1[][9];
-extern const int Servo_Prg_1_Step;
-extern const int Servo_Prg_2[][9];
-extern const int Servo_Prg_2_Step;
-extern const int Servo_Prg_3[][9];
-extern const int Servo_Prg_3_Step;
-extern const int Servo_Prg_4[][9];
-extern const int Servo_Prg_4_Step;
-extern const int Servo_Prg_5[][9];
-extern const int Servo_Prg_5_Step;
-extern const int Servo_Prg_6[][9];
-extern const int Servo_Prg_6_Step;
-extern const int Servo_Prg_7[][9];
-extern const int Servo_Prg_7_Step;
-extern const int Servo_Prg_8[][9];
-extern const int Servo_Prg_8_Step;
-extern const int Servo_Prg_9[][9];
-extern const int Servo_Prg_9_Step;
-extern const int Servo_Prg_10[][9];
-extern const int Servo_Prg_10_Step;
-extern const int Servo_Prg_11[][9];
-extern const int Servo_Prg_11_Step;
-extern const int Servo_Prg_12[][9];
-extern const int Servo_Prg_12_Step;
-extern const int Servo_Prg_13[][9];
-extern const int Servo_Prg_13_Step;
-extern const int Servo_Prg_14[][9];
-extern const int Servo_Prg_14_Step;
-extern const int Servo_Prg_15[][9];
-extern const int Servo_Prg_15_Step;
+// Bewegungstabellen (Zeilen in PROGMEM, siehe Keyframe.h)
+// =============================================================================
+extern const KeyframeTable Servo_Prg_1;
+extern const KeyframeTable Servo_Prg_2;
+extern const KeyframeTable Servo_Prg_3;
+extern const KeyframeTable Servo_Prg_4;
+extern const KeyframeTable Servo_Prg_5;
+extern const KeyframeTable Servo_Prg_6;
+extern const KeyframeTable Servo_Prg_7;
+extern const KeyframeTable Servo_Prg_8;
+extern const KeyframeTable Servo_Prg_9;
+extern const KeyframeTable Servo_Prg_10;
+extern const KeyframeTable Servo_Prg_11;
+extern const KeyframeTable Servo_Prg_12;
+extern const KeyframeTable Servo_Prg_13;
+extern const KeyframeTable Servo_Prg_14;
+extern const KeyframeTable Servo_Prg_15;
 
 #endif // MOTION_DATA_V3_H
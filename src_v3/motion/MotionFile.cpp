@@ -0,0 +1,267 @@
+// =============================================================================
+// MotionFile.cpp - Implementierung der binären Keyframe-Dateien
+// =============================================================================
+#include "MotionFile.h"
+#include "../gait/GaitRuntime.h"
+#include <LittleFS.h>
+
+namespace MotionFile {
+
+static const char* MOTION_DIR = "/motions/";
+static const char* UPLOAD_TMP = "/motions/.upload";
+static const char MAGIC[4] = { 'S', 'P', 'M', 'F' };
+
+// Upload-Zustand
+static File uploadFile;
+static char uploadName[MAX_NAME_LENGTH + 1];
+static bool uploadFailed = false;
+
+// Wiedergabe: Datei bleibt offen, Keyframes werden bei Bedarf gelesen.
+// Ein Keyframe Cache reicht, da Spline-Lookahead und Vorbereitung
+// denselben Keyframe direkt nacheinander lesen.
+static File playFile;
+static char playName[MAX_NAME_LENGTH + 1];
+static GaitSequence playSequence;
+static int cachedStep = -1;
+static Keyframe cachedKeyframe;
+
+// =============================================================================
+// Helper
+// =============================================================================
+bool isValidName(const char* name) {
+    if (!name) return false;
+    size_t len = strlen(name);
+    if (len == 0 || len > MAX_NAME_LENGTH) return false;
+
+    for (size_t i = 0; i < len; i++) {
+        char c = name[i];
+        bool ok = (c >= 'a' && c <= 'z') || (c >= '0' && c <= '9') || c == '_' || c == '-';
+        if (!ok) return false;
+    }
+    return true;
+}
+
+static String pathFor(const char* name) {
+    return String(MOTION_DIR) + name + ".spm";
+}
+
+// Wiedergabe der Datei name beenden und Datei schließen
+static void closePlayback(const char* name) {
+    if (!playFile || strcmp(playName, name) != 0) return;
+
+    const GaitMotionState& state = GaitRuntime::getState();
+    if (state.active && state.chain == &playSequence) {
+        GaitRuntime::stop();
+    }
+    playFile.close();
+    cachedStep = -1;
+}
+
+uint32_t crc32Update(uint32_t crc, const uint8_t* data, size_t len) {
+    crc = ~crc;
+    for (size_t i = 0; i < len; i++) {
+        crc ^= data[i];
+        for (uint8_t bit = 0; bit < 8; bit++) {
+            crc = (crc >> 1) ^ (0xEDB88320UL & (0UL - (crc & 1)));
+        }
+    }
+    return ~crc;
+}
+
+// Header und Keyframe-Block einer offenen Datei prüfen (liest die Datei einmal durch)
+static bool verifyOpenFile(File& f, MotionFileHeader& header) {
+    f.seek(0);
+    if (f.read((uint8_t*)&header, sizeof(header)) != sizeof(header)) return false;
+
+    if (memcmp(header.magic, MAGIC, sizeof(MAGIC)) != 0) {
+        Serial.println(F("[MotionFile] Falsche Kennung"));
+        return false;
+    }
+    if (header.version != FORMAT_VERSION) {
+        Serial.printf("[MotionFile] Version %d nicht unterstützt\n", header.version);
+        return false;
+    }
+    if (header.keyframeCount == 0 || header.keyframeCount > MAX_KEYFRAMES) {
+        Serial.printf("[MotionFile] Ungültige Keyframe-Anzahl: %d\n", header.keyframeCount);
+        return false;
+    }
+    size_t expected = sizeof(header) + (size_t)header.keyframeCount * sizeof(Keyframe);
+    if (f.size() != expected) {
+        Serial.printf("[MotionFile] Größe %u, erwartet %u\n", (unsigned)f.size(), (unsigned)expected);
+        return false;
+    }
+
+    uint8_t buffer[64];
+    uint32_t crc = 0;
+    size_t remaining = expected - sizeof(header);
+    while (remaining > 0) {
+        size_t chunk = remaining < sizeof(buffer) ? remaining : sizeof(buffer);
+        if (f.read(buffer, chunk) != chunk) return false;
+        crc = crc32Update(crc, buffer, chunk);
+        remaining -= chunk;
+    }
+    if (crc != header.crc) {
+        Serial.printf("[MotionFile] CRC-Fehler: %08X, erwartet %08X\n", crc, header.crc);
+        return false;
+    }
+    return true;
+}
+
+// =============================================================================
+// Upload
+// =============================================================================
+bool beginUpload(const char* name) {
+    abortUpload();
+    if (!isValidName(name)) {
+        Serial.println(F("[MotionFile] Ungültiger Name"));
+        return false;
+    }
+
+    uploadFile = LittleFS.open(UPLOAD_TMP, "w");
+    if (!uploadFile) {
+        Serial.println(F("[MotionFile] Upload-Datei nicht anlegbar"));
+        return false;
+    }
+    strncpy(uploadName, name, MAX_NAME_LENGTH);
+    uploadName[MAX_NAME_LENGTH] = '\0';
+    uploadFailed = false;
+    return true;
+}
+
+bool writeChunk(const uint8_t* data, size_t len) {
+    if (!uploadFile || uploadFailed) return false;
+
+    size_t maxSize = sizeof(MotionFileHeader) + (size_t)MAX_KEYFRAMES * sizeof(Keyframe);
+    if (uploadFile.position() + len > maxSize || uploadFile.write(data, len) != len) {
+        Serial.println(F("[MotionFile] Upload zu groß oder Schreibfehler"));
+        uploadFailed = true;
+        return false;
+    }
+    return true;
+}
+
+bool finishUpload() {
+    if (!uploadFile) return false;
+    uploadFile.close();
+
+    MotionFileHeader header;
+    File f = LittleFS.open(UPLOAD_TMP, "r");
+    bool ok = !uploadFailed && f && verifyOpenFile(f, header);
+    if (f) f.close();
+
+    if (!ok) {
+        LittleFS.remove(UPLOAD_TMP);
+        Serial.println(F("[MotionFile] Upload verworfen"));
+        return false;
+    }
+
+    String path = pathFor(uploadName);
+    closePlayback(uploadName);
+    LittleFS.remove(path.c_str());
+    if (!LittleFS.rename(UPLOAD_TMP, path.c_str())) {
+        LittleFS.remove(UPLOAD_TMP);
+        Serial.println(F("[MotionFile] Umbenennen fehlgeschlagen"));
+        return false;
+    }
+
+    Serial.printf("[MotionFile] Gespeichert: %s (%d Keyframes)\n", uploadName, header.keyframeCount);
+    return true;
+}
+
+void abortUpload() {
+    if (uploadFile) {
+        uploadFile.close();
+        LittleFS.remove(UPLOAD_TMP);
+    }
+    uploadFailed = false;
+}
+
+// =============================================================================
+// Prüfen / Verwalten
+// =============================================================================
+bool verify(const char* name, MotionFileHeader* header) {
+    if (!isValidName(name)) return false;
+
+    File f = LittleFS.open(pathFor(name).c_str(), "r");
+    if (!f) return false;
+
+    MotionFileHeader h;
+    bool ok = verifyOpenFile(f, h);
+    f.close();
+    if (ok && header) *header = h;
+    return ok;
+}
+
+bool remove(const char* name) {
+    if (!isValidName(name)) return false;
+
+    // Wiedergabe liest ggf. gerade aus dieser Datei
+    closePlayback(name);
+    return LittleFS.remove(pathFor(name).c_str());
+}
+
+void list(void (*callback)(const char* name, uint16_t keyframes, void* ctx), void* ctx) {
+    Dir dir = LittleFS.openDir(MOTION_DIR);
+    while (dir.next()) {
+        String fileName = dir.fileName();
+        if (!fileName.endsWith(".spm")) continue;
+
+        String name = fileName.substring(0, fileName.length() - 4);
+        MotionFileHeader header;
+        if (verify(name.c_str(), &header)) {
+            callback(name.c_str(), header.keyframeCount, ctx);
+        }
+    }
+}
+
+// =============================================================================
+// Wiedergabe
+// =============================================================================
+static bool readKeyframe(int step, int pose[], int& durationMs) {
+    if (!playFile || step < 0 || step >= playSequence.steps) return false;
+
+    if (step != cachedStep) {
+        size_t offset = sizeof(MotionFileHeader) + (size_t)step * sizeof(Keyframe);
+        if (!playFile.seek(offset) ||
+            playFile.read((uint8_t*)&cachedKeyframe, sizeof(cachedKeyframe)) != sizeof(cachedKeyframe)) {
+            cachedStep = -1;
+            return false;
+        }
+        cachedStep = step;
+    }
+
+    for (int i = 0; i < 8; i++) {
+        pose[i] = cachedKeyframe.angle[i];
+    }
+    durationMs = cachedKeyframe.durationMs;
+    return true;
+}
+
+bool play(const char* name, uint8_t transform) {
+    if (!isValidName(name)) return false;
+
+    // Laufende Wiedergabe endet mit dem Öffnen der neuen Datei
+    closePlayback(playName);
+
+    playFile = LittleFS.open(pathFor(name).c_str(), "r");
+    if (!playFile) {
+        Serial.printf("[MotionFile] Nicht gefunden: %s\n", name);
+        return false;
+    }
+
+    MotionFileHeader header;
+    if (!verifyOpenFile(playFile, header)) {
+        playFile.close();
+        return false;
+    }
+
+    strncpy(playName, name, MAX_NAME_LENGTH);
+    playName[MAX_NAME_LENGTH] = '\0';
+    playSequence = GaitSequence(readKeyframe, header.keyframeCount, transform);
+    GaitRuntime::startChain(&playSequence, 1);
+
+    Serial.printf("[MotionFile] Wiedergabe: %s (%d Keyframes)\n", name, header.keyframeCount);
+    return true;
+}
+
+} // namespace MotionFile
@@ -0,0 +1,65 @@
+// =============================================================================
+// MotionFile.h - Binäre Keyframe-Dateien auf LittleFS
+// =============================================================================
+// v3 Motion Module für ESP8266 Spider Controller
+// Neue Tänze/Gangarten ohne Neu-Flashen: Sequenzen liegen als kompakte
+// Binärdatei unter /motions/<name>.spm und werden Keyframe für Keyframe aus
+// der Datei in GaitRuntime gestreamt (kein Laden der ganzen Sequenz in den Heap).
+//
+// Dateiformat (Little Endian):
+//   Header   16 Byte: "SPMF", version (u8), flags (u8), keyframeCount (u16),
+//                     crc32 (u32, über alle Keyframe-Bytes), reserved (u32)
+//   Keyframe 10 Byte: 8 x Winkel in Grad (u8), Dauer in ms (u16) = struct Keyframe
+// =============================================================================
+#ifndef MOTION_FILE_H
+#define MOTION_FILE_H
+
+#include <Arduino.h>
+#include "Keyframe.h"
+
+struct __attribute__((packed)) MotionFileHeader {
+    char magic[4];
+    uint8_t version;
+    uint8_t flags;
+    uint16_t keyframeCount;
+    uint32_t crc;
+    uint32_t reserved;
+};
+
+static_assert(sizeof(MotionFileHeader) == 16, "MotionFileHeader muss 16 Byte haben");
+
+namespace MotionFile {
+
+static const uint8_t FORMAT_VERSION = 1;
+static const uint16_t MAX_KEYFRAMES = 1024;
+static const uint8_t MAX_NAME_LENGTH = 24;
+
+// Name prüfen: 1-24 Zeichen aus a-z, 0-9, '_' und '-'
+bool isValidName(const char* name);
+
+// Upload in Blöcken (HTTP-Body): Daten landen in einer Temp-Datei und werden
+// erst nach erfolgreicher Prüfung (Header, Größe, CRC) unter name abgelegt.
+bool beginUpload(const char* name);
+bool writeChunk(const uint8_t* data, size_t len);
+bool finishUpload();
+void abortUpload();
+
+// Datei prüfen, optional Header zurückgeben
+bool verify(const char* name, MotionFileHeader* header = nullptr);
+
+// Sequenz über GaitRuntime abspielen (Choreografie, nicht blockierend),
+// transform: KEYFRAME_* Bitmaske (gespiegelt, rückwärts)
+bool play(const char* name, uint8_t transform = 0);
+
+// Datei löschen (laufende Wiedergabe wird vorher beendet)
+bool remove(const char* name);
+
+// Verzeichnis durchlaufen: callback(name, keyframeCount) je gültiger Datei
+void list(void (*callback)(const char* name, uint16_t keyframes, void* ctx), void* ctx);
+
+// CRC32 (IEEE 802.3), fortsetzbar: crc = crc32Update(crc, ...) ab crc = 0
+uint32_t crc32Update(uint32_t crc, const uint8_t* data, size_t len);
+
+} // namespace MotionFile
+
+#endif // MOTION_FILE_H
@@ -0,0 +1,277 @@
+// =============================================================================
+// ServoOutput.cpp - Frame-synchrone Servo-Ausgabe (Timer1-ISR)
+// =============================================================================
+// Ablauf pro 20-ms-Frame (ISR):
+//   1. Frame-Grenze: frameBuf[frontIdx] übernehmen
+//   2. Kanal k startet staggerUs * k nach der Grenze, sein Ende wird ab dem
+//      tatsächlichen Start einsortiert; ein Timer-Interrupt je Flanke
+//   3. Nächste Frame-Grenze im festen Raster (CCOUNT), nicht relativ zur ISR
+// Jede Flanke misst ihre Verspätung gegenüber dem Soll-Zeitpunkt.
+//
+// Die Servo-Library kann hier nicht verwendet werden: ihr Waveform-Generator
+// belegt Timer1 und writeMicroseconds() ist nicht ISR-fest.
+// =============================================================================
+#include "ServoOutput.h"
+
+#if !SERVO_FRAME_ISR
+#include <Servo.h>
+#endif
+
+namespace ServoOutput {
+
+// Kanal -> GPIO (Reihenfolge wie Running_Servo_POS)
+static const uint8_t SERVO_PINS[SERVO_COUNT] = { 14, 12, 13, 15, 16, 5, 4, 2 };
+
+static FrameStats stats = FrameStats();
+static unsigned long lastCommitUs = 0;
+static bool commitSeen = false;
+
+#if SERVO_FRAME_ISR
+
+// Timer1 mit DIV16 am 80-MHz-APB: 5 Ticks pro µs
+static const uint32_t TIMER_TICKS_PER_US = 5;
+// Ereignisse, die näher liegen, in derselben ISR abarbeiten
+static const uint32_t ISR_MIN_WAIT_US = 4;
+static const uint32_t CCY_PER_US = clockCyclesPerMicrosecond();
+
+// Double-Buffer: die ISR liest nur frameBuf[frontIdx], setPulseUs() schreibt
+// nur in den anderen. commit() tauscht mit einem einzigen Byte-Store.
+static volatile uint16_t frameBuf[2][SERVO_COUNT];
+static volatile uint8_t frontIdx = 0;
+static volatile bool framePending = false;
+static bool dirty = false;
+
+// ISR-Zustand
+static uint16_t isrPulse[SERVO_COUNT];
+static uint8_t isrActive[SERVO_COUNT];    // Kanäle mit Puls in Startreihenfolge
+static uint8_t isrActiveCount = 0;
+static uint8_t isrRiseNext = 0;           // nächster Pulsstart in isrActive
+static uint32_t isrStaggerCcy = 0;        // Versatz pro Kanal in diesem Frame
+static uint8_t isrFallCh[SERVO_COUNT];    // laufende Pulse, nach Ende sortiert
+static uint32_t isrFallCcy[SERVO_COUNT];
+static uint8_t isrFallCount = 0;
+static bool isrInFrame = false;
+static bool isrStarted = false;
+static uint32_t isrFrameCcy = 0;          // Soll-Zeitpunkt der Frame-Grenze
+static uint32_t isrLastFrameCcy = 0;      // tatsächlicher Beginn des letzten Frames
+
+static inline void IRAM_ATTR pinHigh(uint8_t pin) {
+    if (pin == 16) {
+        GP16O |= 1;
+    } else {
+        GPOS = (1 << pin);
+    }
+}
+
+static inline void IRAM_ATTR pinLow(uint8_t pin) {
+    if (pin == 16) {
+        GP16O &= ~1;
+    } else {
+        GPOC = (1 << pin);
+    }
+}
+
+static inline bool IRAM_ATTR isDue(uint32_t atCcy, uint32_t now) {
+    return (int32_t)(atCcy - now) <= 0;
+}
+
+// Slot des Pulsstarts: fest pro Kanal, unabhängig davon, welche Kanäle aktiv sind
+static inline uint32_t IRAM_ATTR riseCcy(uint8_t channel) {
+    return isrFrameCcy + channel * isrStaggerCcy;
+}
+
+static void IRAM_ATTR recordInterval(uint32_t intervalUs) {
+    uint32_t dev = intervalUs > SERVO_FRAME_US ? intervalUs - SERVO_FRAME_US : SERVO_FRAME_US - intervalUs;
+    if (dev > stats.maxJitterUs) stats.maxJitterUs = dev;
+    uint8_t b = 0;
+    while (b < FRAME_JITTER_BUCKETS - 1 && dev > FRAME_JITTER_LIMITS_US[b]) b++;
+    stats.histogram[b]++;
+}
+
+// Frame-Grenze: Buffer übernehmen, Versatz für diesen Frame festlegen
+static void IRAM_ATTR startFrame(uint32_t now) {
+    if (isrStarted) recordInterval((now - isrLastFrameCcy) / CCY_PER_US);
+    isrStarted = true;
+    isrLastFrameCcy = now;
+    stats.frames++;
+    if (framePending) {
+        framePending = false;
+        stats.fresh++;
+    }
+
+    const volatile uint16_t* src = frameBuf[frontIdx];
+    isrActiveCount = 0;
+    for (uint8_t ch = 0; ch < SERVO_COUNT; ch++) {
+        isrPulse[ch] = src[ch];
+        if (isrPulse[ch] != 0) isrActive[isrActiveCount++] = ch;
+    }
+    isrRiseNext = 0;
+    isrFallCount = 0;
+
+    uint32_t stagger = gaitConfig.pwm.staggerUs;
+    if (stagger > PWM_STAGGER_MAX_US) stagger = PWM_STAGGER_MAX_US;
+    isrStaggerCcy = stagger * CCY_PER_US;
+}
+
+static void IRAM_ATTR risePulse(uint8_t channel, uint32_t now) {
+    pinHigh(SERVO_PINS[channel]);
+    uint32_t lateUs = (now - riseCcy(channel)) / CCY_PER_US;
+    if (lateUs > stats.riseLateMaxUs) stats.riseLateMaxUs = lateUs;
+
+    // Ende ab dem tatsächlichen Start, damit eine späte ISR die Breite nicht ändert
+    uint32_t fallAt = now + isrPulse[channel] * CCY_PER_US;
+    uint8_t j = isrFallCount++;
+    while (j > 0 && (int32_t)(isrFallCcy[j - 1] - fallAt) > 0) {
+        isrFallCh[j] = isrFallCh[j - 1];
+        isrFallCcy[j] = isrFallCcy[j - 1];
+        j--;
+    }
+    isrFallCh[j] = channel;
+    isrFallCcy[j] = fallAt;
+    if (isrFallCount > stats.maxConcurrent) stats.maxConcurrent = isrFallCount;
+}
+
+static void IRAM_ATTR endPulse(uint32_t now) {
+    pinLow(SERVO_PINS[isrFallCh[0]]);
+    uint32_t errCcy = now - isrFallCcy[0];
+    uint32_t errUs = errCcy / CCY_PER_US;
+    if (errUs > stats.widthErrMaxUs) stats.widthErrMaxUs = errUs;
+    stats.widthErrSumTenthUs += errCcy * 10 / CCY_PER_US;
+    stats.pulses++;
+
+    isrFallCount--;
+    for (uint8_t j = 0; j < isrFallCount; j++) {
+        isrFallCh[j] = isrFallCh[j + 1];
+        isrFallCcy[j] = isrFallCcy[j + 1];
+    }
+}
+
+static void IRAM_ATTR frameIsr() {
+    for (;;) {
+        uint32_t now = ESP.getCycleCount();
+        if (!isrInFrame) {
+            startFrame(now);
+            isrInFrame = true;
+        }
+
+        // Fällige Flanken abarbeiten, Pulsenden vor Pulsstarts
+        for (;;) {
+            now = ESP.getCycleCount();
+            if (isrFallCount > 0 && isDue(isrFallCcy[0], now)) {
+                endPulse(now);
+            } else if (isrRiseNext < isrActiveCount && isDue(riseCcy(isrActive[isrRiseNext]), now)) {
+                risePulse(isrActive[isrRiseNext++], now);
+            } else {
+                break;
+            }
+        }
+
+        // Nächstes Ereignis
+        bool risePending = isrRiseNext < isrActiveCount;
+        uint32_t nextCcy;
+        if (isrFallCount > 0) {
+            nextCcy = isrFallCcy[0];
+            if (risePending && (int32_t)(riseCcy(isrActive[isrRiseNext]) - nextCcy) < 0) {
+                nextCcy = riseCcy(isrActive[isrRiseNext]);
+            }
+        } else if (risePending) {
+            nextCcy = riseCcy(isrActive[isrRiseNext]);
+        } else {
+            // Frame fertig, nächste Grenze im festen Raster
+            isrInFrame = false;
+            isrFrameCcy += SERVO_FRAME_US * CCY_PER_US;
+            if ((int32_t)(now - isrFrameCcy) > (int32_t)(SERVO_FRAME_US / 2 * CCY_PER_US)) {
+                // Grenze weit verpasst (Interrupts zu lange gesperrt): Raster neu starten
+                stats.resyncs++;
+                isrFrameCcy = now;
+            }
+            nextCcy = isrFrameCcy;
+        }
+
+        int32_t waitCcy = (int32_t)(nextCcy - ESP.getCycleCount());
+        if (waitCcy >= (int32_t)(ISR_MIN_WAIT_US * CCY_PER_US)) {
+            timer1_write((uint32_t)waitCcy / CCY_PER_US * TIMER_TICKS_PER_US);
+            return;
+        }
+    }
+}
+
+void begin() {
+    for (uint8_t ch = 0; ch < SERVO_COUNT; ch++) {
+        pinMode(SERVO_PINS[ch], OUTPUT);
+        digitalWrite(SERVO_PINS[ch], LOW);
+        frameBuf[0][ch] = 0;
+        frameBuf[1][ch] = 0;
+    }
+
+    isrFrameCcy = ESP.getCycleCount() + SERVO_FRAME_US * CCY_PER_US;
+    timer1_isr_init();
+    timer1_attachInterrupt(frameIsr);
+    timer1_enable(TIM_DIV16, TIM_EDGE, TIM_SINGLE);
+    timer1_write(SERVO_FRAME_US * TIMER_TICKS_PER_US);
+    Serial.printf("[Servo] Frame-ISR aktiv (%u µs)\n", (unsigned)SERVO_FRAME_US);
+}
+
+void setPulseUs(uint8_t channel, uint16_t pulseUs) {
+    if (channel >= SERVO_COUNT) return;
+    frameBuf[frontIdx ^ 1][channel] = pulseUs;
+    dirty = true;
+}
+
+#else // !SERVO_FRAME_ISR
+
+static Servo servos[SERVO_COUNT];
+
+void begin() {
+    for (uint8_t ch = 0; ch < SERVO_COUNT; ch++) {
+        servos[ch].attach(SERVO_PINS[ch], SERVO_PULSE_MIN_US, SERVO_PULSE_MAX_US);
+    }
+}
+
+void setPulseUs(uint8_t channel, uint16_t pulseUs) {
+    if (channel >= SERVO_COUNT || pulseUs == 0) return;
+    servos[channel].writeMicroseconds(pulseUs);
+}
+
+#endif // SERVO_FRAME_ISR
+
+void commit() {
+    unsigned long nowUs = micros();
+    if (commitSeen) {
+        uint32_t gap = nowUs - lastCommitUs;
+        if (gap > stats.maxCommitGapUs) stats.maxCommitGapUs = gap;
+    }
+    lastCommitUs = nowUs;
+    commitSeen = true;
+
+#if SERVO_FRAME_ISR
+    if (!dirty) return;
+    dirty = false;
+    stats.commits++;
+
+    // Tauschen: die ISR sieht ab jetzt den fertigen Buffer
+    uint8_t back = frontIdx ^ 1;
+    frontIdx = back;
+    framePending = true;
+
+    // Neuer Backbuffer startet mit dem veröffentlichten Stand
+    for (uint8_t ch = 0; ch < SERVO_COUNT; ch++) {
+        frameBuf[back ^ 1][ch] = frameBuf[back][ch];
+    }
+#endif
+}
+
+void getStats(FrameStats& out) {
+    noInterrupts();
+    out = stats;
+    interrupts();
+}
+
+void resetStats() {
+    noInterrupts();
+    stats = FrameStats();
+    interrupts();
+    commitSeen = false;
+}
+
+} // namespace ServoOutput
@@ -0,0 +1,60 @@
+// =============================================================================
+// ServoOutput.h - Frame-synchrone Servo-Ausgabe (Timer1-ISR)
+// =============================================================================
+// Die Motion-Schicht schreibt Pulsbreiten in einen Backbuffer und
+// veröffentlicht ihn mit commit(). Die Timer1-ISR übernimmt an jeder
+// 20-ms-Frame-Grenze den zuletzt veröffentlichten Buffer für alle 8 Kanäle
+// und erzeugt die Pulse selbst. Wann loop() dran ist, spielt für den
+// Ausgabetakt damit keine Rolle mehr.
+// Die Pulsstarts sind um gaitConfig.pwm.staggerUs pro Kanal versetzt, damit
+// nicht alle Servos im selben Moment Strom ziehen.
+// SERVO_FRAME_ISR = 0: Ausgabe wie bisher direkt über die Servo-Library.
+// =============================================================================
+#ifndef SERVO_OUTPUT_H
+#define SERVO_OUTPUT_H
+
+#include <Arduino.h>
+#include "../gait/GaitConfig.h"
+
+namespace ServoOutput {
+
+// Jitter-Histogramm: Abweichung des Frame-Abstands von SERVO_FRAME_US,
+// Obergrenzen der Klassen in µs (letzte Klasse = darüber)
+static const uint8_t FRAME_JITTER_BUCKETS = 8;
+static const uint16_t FRAME_JITTER_LIMITS_US[FRAME_JITTER_BUCKETS - 1] = {
+    5, 10, 25, 50, 100, 250, 1000
+};
+
+struct FrameStats {
+    uint32_t frames;            // Ausgegebene Frames
+    uint32_t fresh;             // davon mit neu veröffentlichten Werten
+    uint32_t resyncs;           // Frame-Grenze verpasst, Takt neu gestartet
+    uint32_t commits;           // commit() mit Änderungen
+    uint32_t maxJitterUs;       // größte Abweichung vom Frame-Abstand
+    uint32_t maxCommitGapUs;    // größter Abstand zwischen zwei commit() (loop-Jitter)
+    uint32_t histogram[FRAME_JITTER_BUCKETS];
+    
+    // Flanken-Genauigkeit (gemessen mit dem CPU-Zyklenzähler)
+    uint32_t pulses;            // ausgegebene Pulse
+    uint32_t riseLateMaxUs;     // größte Verspätung eines Pulsstarts gegenüber seinem Slot
+    uint32_t widthErrMaxUs;     // größte Abweichung der Pulsbreite
+    uint32_t widthErrSumTenthUs; // Summe der Abweichungen in 0.1 µs (Mittel = Summe / pulses)
+    uint8_t maxConcurrent;      // höchste Zahl gleichzeitig aktiver Pulse
+};
+
+// Pins konfigurieren und Frame-Takt starten (in setup())
+void begin();
+
+// Pulsbreite für Kanal channel in den Backbuffer schreiben (0 = kein Puls)
+void setPulseUs(uint8_t channel, uint16_t pulseUs);
+
+// Backbuffer veröffentlichen, die ISR übernimmt ihn an der nächsten Frame-Grenze
+void commit();
+
+// Statistik (Kopie, konsistent gegenüber der ISR)
+void getStats(FrameStats& out);
+void resetStats();
+
+} // namespace ServoOutput
+
+#endif // SERVO_OUTPUT_H
@@ -3,6 +3,7 @@
 // =============================================================================
 #include "RobotController_v3.h"
 #include "../motion/MotionData_v3.h"
+#include "../motion/MotionFile.h"
 #include "../gait/GaitRuntime.h"
 #include "../calibration/ServoCalibration.h"
 
@@ -14,13 +15,22 @@ RobotControllerV3 robotController;
 // =============================================================================
 RobotControllerV3::RobotControllerV3() 
     : currentCmd(MotionCmd::NONE)
+    , activeGaitCmd(MotionCmd::NONE)
+    , previousGaitCmd(MotionCmd::NONE)
     , pendingCmd(MotionCmd::NONE)
     , hasPendingCmd(false)
     , continuousMode(false)
     , stopAfterSequence(false)
     , motionRunning(false)
     , calibrationLocked(true)
-    , walkParams() {}
+    , gaitEngine(GaitEngine::KEYFRAME)
+    , vectorMode(false)
+    , moveVec()
+    , motionFileTransform(0)
+    , enterAtClosest(false)
+    , walkParams() {
+    motionFileName[0] = '\0';
+}
 
 // =============================================================================
 // Command Parsing
@@ -69,6 +79,7 @@ const char* RobotControllerV3::getCommandName(MotionCmd cmd) {
         case MotionCmd::DANCE2: return "dance2";
         case MotionCmd::DANCE3: return "dance3";
         case MotionCmd::CALIBPOSE: return "calibpose";
+        case MotionCmd::MOTIONFILE: return "motionfile";
         default: return "none";
     }
 }
@@ -91,11 +102,17 @@ void RobotControllerV3::queueCommand(MotionCmd cmd) {
     noInterrupts();
     pendingCmd = cmd;
     hasPendingCmd = true;
+    vectorMode = false;
     if (continuousMode) {
         continuousMode = false;
         stopAfterSequence = false;
     }
     interrupts();
+    
+    // Gangart endet am nächsten Keyframe, Choreografien laufen zu Ende,
+    // danach Pending Command
+    GaitRuntime::setLooping(false);
+    preemptKeyframeGait();
     Serial.printf("[RobotV3] Command queued: %s\n", getCommandName(cmd));
 }
 
@@ -113,8 +130,73 @@ void RobotControllerV3::startContinuous(MotionCmd cmd) {
     noInterrupts();
     stopAfterSequence = false;
     continuousMode = true;
+    vectorMode = false;
     currentCmd = cmd;
     interrupts();
+    
+    // CPG läuft bereits: Richtung sofort gleitend umstellen
+    bool cpgRunning = motionRunning && GaitRuntime::getState().source == GaitSource::CPG;
+    if (cpgRunning && usesCpg(cmd)) {
+        applyCpgCommand(cmd);
+        activeGaitCmd = cmd;
+        GaitRuntime::setLooping(true);
+        return;
+    }
+    
+    // Gleiche Gangart läuft bereits: nahtlos weiterlaufen, sonst am nächsten
+    // Keyframe wechseln
+    bool sameGait = motionRunning && !cpgRunning && activeGaitCmd == cmd;
+    GaitRuntime::setLooping(sameGait);
+    if (!sameGait) {
+        preemptKeyframeGait();
+    }
+}
+
+void RobotControllerV3::setMoveVector(float vx, float vy, float yaw) {
+    const float VECTOR_DEAD_ZONE = 0.05f;
+    
+    if (fabsf(vx) < VECTOR_DEAD_ZONE && fabsf(vy) < VECTOR_DEAD_ZONE &&
+        fabsf(yaw) < VECTOR_DEAD_ZONE) {
+        requestStop();
+        return;
+    }
+    
+    bool wasVectorMode = vectorMode;
+    moveVec.vx = constrain(vx, -1.0f, 1.0f);
+    moveVec.vy = constrain(vy, -1.0f, 1.0f);
+    moveVec.yaw = constrain(yaw, -1.0f, 1.0f);
+    MotionCmd cmd = dominantCmd(moveVec);
+    
+    noInterrupts();
+    stopAfterSequence = false;
+    continuousMode = true;
+    vectorMode = true;
+    currentCmd = cmd;
+    interrupts();
+    
+    if (!wasVectorMode) {
+        Serial.printf("[RobotV3] Vektor-Modus: vx=%.2f, vy=%.2f, yaw=%.2f\n",
+            moveVec.vx, moveVec.vy, moveVec.yaw);
+        applyWalkParams();
+    }
+    
+    // CPG läuft: Vektor wirkt sofort (gleitend über max. einen Zyklus)
+    bool cpgRunning = motionRunning && GaitRuntime::getState().source == GaitSource::CPG;
+    if (cpgRunning && usesCpg(cmd)) {
+        applyCpgCommand(cmd);
+        activeGaitCmd = cmd;
+        GaitRuntime::setLooping(true);
+        return;
+    }
+    
+    // Keyframe-Engine: dominante Richtung als Gangart, dieselbe läuft nahtlos
+    // weiter. Sonst endet die laufende Gangart am nächsten Keyframe und
+    // processQueue() startet die neue.
+    bool sameGait = motionRunning && !cpgRunning && !usesCpg(cmd) && activeGaitCmd == cmd;
+    GaitRuntime::setLooping(sameGait);
+    if (!sameGait) {
+        preemptKeyframeGait();
+    }
 }
 
 void RobotControllerV3::requestStop() {
@@ -124,6 +206,7 @@ void RobotControllerV3::requestStop() {
         noInterrupts();
         continuousMode = false;
         stopAfterSequence = false;
+        vectorMode = false;
         currentCmd = MotionCmd::STANDBY;
         interrupts();
         startMotionForCmd(MotionCmd::STANDBY);
@@ -132,7 +215,28 @@ void RobotControllerV3::requestStop() {
     }
     
     stopAfterSequence = true;
-    Serial.println(F("[RobotV3] Stop nach Sequenz angefordert"));
+    vectorMode = false;
+    
+    // Mit Ramp: Schritte über ramp.stopSegments Segmente verkleinern
+    if (isContinuousCmd(activeGaitCmd) && GaitRuntime::softStop()) {
+        enterAtClosest = true;
+        Serial.println(F("[RobotV3] Soft-Stop angefordert"));
+        return;
+    }
+    
+    GaitRuntime::setLooping(false);
+    preemptKeyframeGait();
+    Serial.println(F("[RobotV3] Stop am nächsten Keyframe angefordert"));
+}
+
+bool RobotControllerV3::playMotionFile(const char* name, uint8_t transform) {
+    if (!MotionFile::isValidName(name)) return false;
+    
+    strncpy(motionFileName, name, sizeof(motionFileName) - 1);
+    motionFileName[sizeof(motionFileName) - 1] = '\0';
+    motionFileTransform = transform;
+    queueCommand(MotionCmd::MOTIONFILE);
+    return true;
 }
 
 void RobotControllerV3::forceStop() {
@@ -144,6 +248,7 @@ void RobotControllerV3::forceStop() {
     stopAfterSequence = false;
     motionRunning = false;
     hasPendingCmd = false;
+    vectorMode = false;
     currentCmd = MotionCmd::STANDBY;
     pendingCmd = MotionCmd::NONE;
     interrupts();
@@ -151,59 +256,93 @@ void RobotControllerV3::forceStop() {
     startMotionForCmd(MotionCmd::STANDBY);
 }
 
+void RobotControllerV3::preemptKeyframeGait() {
+    if (!motionRunning || !isContinuousCmd(activeGaitCmd) ||
+        GaitRuntime::getState().source != GaitSource::KEYFRAME) {
+        return;
+    }
+    GaitRuntime::preemptAtKeyframe();
+    enterAtClosest = true;
+}
+
+void RobotControllerV3::startKeyframeGait(const KeyframeTable& table) {
+    // Soft-Start nur aus dem Stand, nicht bei Richtungswechseln
+    if (isContinuousCmd(currentCmd) && !isContinuousCmd(previousGaitCmd)) {
+        GaitRuntime::rampUpFromRest(table.steps * walkParams.rampCycles);
+    }
+    int startStep = enterAtClosest ? GaitRuntime::closestKeyframe(table) : 0;
+    GaitRuntime::start(table, startStep);
+}
+
+// =============================================================================
+// Choreografien als Sequenz-Ketten (gleiche Abfolge wie die blockierenden
+// Aktionen in MotionData, z.B. hello() = Winken + Standby)
+// =============================================================================
+static const GaitSequence CHOREO_SLEEP[]    = { Servo_Prg_1, Servo_Prg_12 };
+static const GaitSequence CHOREO_LIE[]      = { Servo_Prg_8 };
+static const GaitSequence CHOREO_HELLO[]    = { Servo_Prg_9, Servo_Prg_1 };
+static const GaitSequence CHOREO_FIGHTING[] = { Servo_Prg_10 };
+static const GaitSequence CHOREO_PUSHUP[]   = { Servo_Prg_11 };
+static const GaitSequence CHOREO_DANCE1[]   = { Servo_Prg_13 };
+static const GaitSequence CHOREO_DANCE2[]   = { Servo_Prg_14 };
+static const GaitSequence CHOREO_DANCE3[]   = { Servo_Prg_15 };
+
+template <size_t N>
+static void startChoreography(const GaitSequence (&chain)[N]) {
+    GaitRuntime::startChain(chain, N);
+}
+
 // =============================================================================
 // Motion starten mit GaitRuntime
 // =============================================================================
 void RobotControllerV3::startMotionForCmd(MotionCmd cmd) {
     currentCmd = cmd;
+    previousGaitCmd = activeGaitCmd;
+    activeGaitCmd = cmd;
     GaitRuntime::resetSequenceFlag();
     motionRunning = true;
     
-    switch (cmd) {
-        case MotionCmd::FORWARD:   GaitRuntime::start(Servo_Prg_2, Servo_Prg_2_Step); break;
-        case MotionCmd::BACKWARD:  GaitRuntime::start(Servo_Prg_3, Servo_Prg_3_Step); break;
-        case MotionCmd::LEFT:      GaitRuntime::start(Servo_Prg_4, Servo_Prg_4_Step); break;
-        case MotionCmd::RIGHT:     GaitRuntime::start(Servo_Prg_5, Servo_Prg_5_Step); break;
-        case MotionCmd::TURNLEFT:  GaitRuntime::start(Servo_Prg_6, Servo_Prg_6_Step); break;
-        case MotionCmd::TURNRIGHT: GaitRuntime::start(Servo_Prg_7, Servo_Prg_7_Step); break;
-        case MotionCmd::STANDBY:   GaitRuntime::start(Servo_Prg_1, Servo_Prg_1_Step); break;
-        default: motionRunning = false; break;
+    if (usesCpg(cmd)) {
+        applyCpgCommand(cmd);
+        GaitRuntime::startCpg();
+    } else switch (cmd) {
+        case MotionCmd::FORWARD:   startKeyframeGait(Servo_Prg_2); break;
+        case MotionCmd::BACKWARD:  startKeyframeGait(Servo_Prg_3); break;
+        case MotionCmd::LEFT:      startKeyframeGait(Servo_Prg_4); break;
+        case MotionCmd::RIGHT:     startKeyframeGait(Servo_Prg_5); break;
+        case MotionCmd::TURNLEFT:  startKeyframeGait(Servo_Prg_6); break;
+        case MotionCmd::TURNRIGHT: startKeyframeGait(Servo_Prg_7); break;
+        case MotionCmd::STANDBY:   startKeyframeGait(Servo_Prg_1); break;
+        case MotionCmd::SLEEP:     startChoreography(CHOREO_SLEEP);    break;
+        case MotionCmd::LIE:       startChoreography(CHOREO_LIE);      break;
+        case MotionCmd::HELLO:     startChoreography(CHOREO_HELLO);    break;
+        case MotionCmd::PUSHUP:    startChoreography(CHOREO_PUSHUP);   break;
+        case MotionCmd::FIGHTING:  startChoreography(CHOREO_FIGHTING); break;
+        case MotionCmd::DANCE1:    startChoreography(CHOREO_DANCE1);   break;
+        case MotionCmd::DANCE2:    startChoreography(CHOREO_DANCE2);   break;
+        case MotionCmd::DANCE3:    startChoreography(CHOREO_DANCE3);   break;
+        case MotionCmd::MOTIONFILE:
+            if (!MotionFile::play(motionFileName, motionFileTransform)) {
+                motionRunning = false;
+                activeGaitCmd = MotionCmd::NONE;
+            }
+            break;
+        default: motionRunning = false; activeGaitCmd = MotionCmd::NONE; break;
     }
-}
-
-void RobotControllerV3::executeCommandBlocking(MotionCmd cmd) {
-    currentCmd = cmd;
+    enterAtClosest = false;
     
-    switch (cmd) {
-        case MotionCmd::FORWARD:   forward_blocking();   break;
-        case MotionCmd::BACKWARD:  back_blocking();      break;
-        case MotionCmd::LEFT:      leftmove_blocking();  break;
-        case MotionCmd::RIGHT:     rightmove_blocking(); break;
-        case MotionCmd::TURNLEFT:  turnleft_blocking();  break;
-        case MotionCmd::TURNRIGHT: turnright_blocking(); break;
-        case MotionCmd::STANDBY:   standby();   break;
-        case MotionCmd::SLEEP:     sleep();     break;
-        case MotionCmd::LIE:       lie();       break;
-        case MotionCmd::HELLO:     hello();     break;
-        case MotionCmd::PUSHUP:    pushup();    break;
-        case MotionCmd::FIGHTING:  fighting();  break;
-        case MotionCmd::DANCE1:    dance1();    break;
-        case MotionCmd::DANCE2:    dance2();    break;
-        case MotionCmd::DANCE3:    dance3();    break;
-        case MotionCmd::CALIBPOSE: calibpose(); break;
-        default: break;
-    }
+    // Kontinuierliche Gangarten laufen in GaitRuntime ohne Neustart pro Zyklus
+    GaitRuntime::setLooping(motionRunning && continuousMode && !stopAfterSequence &&
+                            isContinuousCmd(cmd));
 }
 
 // =============================================================================
 // Haupt-Prozessschleife
 // =============================================================================
 void RobotControllerV3::processQueue() {
-    unsigned long now = millis();
-    
-    // GaitRuntime ticken wenn Motion aktiv
+    // GaitRuntime ticken wenn Motion aktiv (Zyklusgrenzen werden intern überbrückt)
     if (motionRunning) {
-        if (GaitRuntime::tick(now)) {
+        if (GaitRuntime::tick(micros())) {
             return;  // Motion läuft noch
         }
         
@@ -224,9 +363,9 @@ void RobotControllerV3::processQueue() {
             startMotionForCmd(MotionCmd::STANDBY);
             return;
         }
-        // Kontinuierlich: Sequenz wiederholen
+        // Kontinuierlich: Gangart hat gewechselt (gleiche Gangart läuft im Loop weiter)
         else if (continuousMode) {
-            Serial.printf("[RobotV3] Sequenz wiederholen: %s\n", getCommandName(currentCmd));
+            Serial.printf("[RobotV3] Wechsel zu: %s\n", getCommandName(currentCmd));
             startMotionForCmd(currentCmd);
             return;
         }
@@ -248,10 +387,13 @@ void RobotControllerV3::processQueue() {
             applyWalkParams();
         }
         
-        if (cmd == MotionCmd::STANDBY || isContinuousCmd(cmd)) {
-            startMotionForCmd(cmd);
+        // Alles außer der Kalibrierpose (sofortiges Setzen) läuft über GaitRuntime,
+        // loop() blockiert nie und Stop greift im nächsten Tick
+        if (cmd == MotionCmd::CALIBPOSE) {
+            currentCmd = cmd;
+            calibpose();
         } else {
-            executeCommandBlocking(cmd);
+            startMotionForCmd(cmd);
         }
         return;
     }
@@ -280,6 +422,7 @@ void RobotControllerV3::setWalkParams(const WalkParams& params) {
 void RobotControllerV3::applyWalkParams() {
     GaitRuntime::setStrideFactor(walkParams.stride);
     GaitRuntime::setSubSteps(walkParams.subSteps);
+    GaitRuntime::setInterpolationMode(walkParams.interp);
     GaitRuntime::setTimingProfile(walkParams.profile);
     GaitRuntime::setSwingMultiplier(walkParams.swingMul);
     GaitRuntime::setStanceMultiplier(walkParams.stanceMul);
@@ -300,6 +443,11 @@ void RobotControllerV3::setSubSteps(uint8_t steps) {
     GaitRuntime::setSubSteps(steps);
 }
 
+void RobotControllerV3::setInterpolationMode(InterpolationMode mode) {
+    walkParams.interp = mode;
+    GaitRuntime::setInterpolationMode(mode);
+}
+
 void RobotControllerV3::setTimingProfile(TimingProfile profile) {
     walkParams.profile = profile;
     GaitRuntime::setTimingProfile(profile);
@@ -321,6 +469,61 @@ void RobotControllerV3::enableRamp(bool enable, uint8_t cycles) {
     GaitRuntime::enableRamp(enable, cycles);
 }
 
+// =============================================================================
+// Gait-Engine
+// =============================================================================
+void RobotControllerV3::setGaitEngine(GaitEngine engine) {
+    if (gaitEngine == engine) return;
+    gaitEngine = engine;
+    
+    // Laufende Gangart beendet ihren Zyklus, danach startet die neue Engine
+    if (motionRunning && isContinuousCmd(activeGaitCmd)) {
+        GaitRuntime::setLooping(false);
+    }
+    Serial.printf("[RobotV3] Gait-Engine: %s\n", getGaitEngineName());
+}
+
+const char* RobotControllerV3::getGaitEngineName() const {
+    return gaitEngine == GaitEngine::CPG ? "cpg" : "keyframe";
+}
+
+bool RobotControllerV3::usesCpg(MotionCmd cmd) {
+    // Auch moveVec folgt der Engine: mit Keyframes läuft die dominante Richtung
+    // (Keyframes lassen sich nicht überlagern)
+    return isContinuousCmd(cmd) && gaitEngine == GaitEngine::CPG;
+}
+
+void RobotControllerV3::applyCpgCommand(MotionCmd cmd) {
+    if (vectorMode) {
+        GaitRuntime::setCpgCommand(moveVec.vx, moveVec.vy, moveVec.yaw);
+        return;
+    }
+    
+    switch (cmd) {
+        case MotionCmd::FORWARD:   GaitRuntime::setCpgCommand( 1.0f,  0.0f,  0.0f); break;
+        case MotionCmd::BACKWARD:  GaitRuntime::setCpgCommand(-1.0f,  0.0f,  0.0f); break;
+        case MotionCmd::LEFT:      GaitRuntime::setCpgCommand( 0.0f, -1.0f,  0.0f); break;
+        case MotionCmd::RIGHT:     GaitRuntime::setCpgCommand( 0.0f,  1.0f,  0.0f); break;
+        case MotionCmd::TURNLEFT:  GaitRuntime::setCpgCommand( 0.0f,  0.0f, -1.0f); break;
+        case MotionCmd::TURNRIGHT: GaitRuntime::setCpgCommand( 0.0f,  0.0f,  1.0f); break;
+        default: break;
+    }
+}
+
+MotionCmd RobotControllerV3::dominantCmd(const MoveVector& v) const {
+    float ax = fabsf(v.vx);
+    float ay = fabsf(v.vy);
+    float ayaw = fabsf(v.yaw);
+    
+    if (ayaw >= ax && ayaw >= ay) {
+        return v.yaw > 0 ? MotionCmd::TURNRIGHT : MotionCmd::TURNLEFT;
+    }
+    if (ay > ax) {
+        return v.vy > 0 ? MotionCmd::RIGHT : MotionCmd::LEFT;
+    }
+    return v.vx >= 0 ? MotionCmd::FORWARD : MotionCmd::BACKWARD;
+}
+
 // =============================================================================
 // Kalibrierung
 // =============================================================================
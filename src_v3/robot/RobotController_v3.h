@@ -7,12 +7,15 @@
 //   - Walk-Parameter (stride, subSteps, timing) Unterstützung
 //   - Kalibrierungs-Integration
 //   - Erweitertes Command-Handling
+//   - Wahl der Gait-Engine (Keyframe-Tabellen oder CPG)
+//   - Kontinuierlicher Bewegungsvektor (vx, vy, yaw) über den CPG
 // =============================================================================
 #ifndef ROBOT_CONTROLLER_V3_H
 #define ROBOT_CONTROLLER_V3_H
 
 #include <Arduino.h>
 #include "../gait/GaitConfig.h"
+#include "../motion/Keyframe.h"
 
 // =============================================================================
 // Motion Commands
@@ -34,7 +37,27 @@ enum class MotionCmd : uint8_t {
     DANCE1,
     DANCE2,
     DANCE3,
-    CALIBPOSE
+    CALIBPOSE,
+    MOTIONFILE      // Binäre Sequenz von LittleFS (MotionFile)
+};
+
+// =============================================================================
+// Gait-Engine für Laufbewegungen
+// =============================================================================
+enum class GaitEngine : uint8_t {
+    KEYFRAME = 0,   // PROGMEM-Keyframe-Tabellen
+    CPG             // Parametrischer Oszillator
+};
+
+// =============================================================================
+// Bewegungsvektor (normiert, -1.0 - 1.0)
+// =============================================================================
+struct MoveVector {
+    float vx;       // Vorwärts (+) / Rückwärts (-)
+    float vy;       // Rechts (+) / Links (-)
+    float yaw;      // Rechtsdrehung (+) / Linksdrehung (-)
+    
+    MoveVector() : vx(0.0f), vy(0.0f), yaw(0.0f) {}
 };
 
 // =============================================================================
@@ -43,6 +66,7 @@ enum class MotionCmd : uint8_t {
 struct WalkParams {
     float stride;           // Stride-Faktor (0.3 - 2.0)
     uint8_t subSteps;       // Substeps (1-16)
+    InterpolationMode interp; // Interpolation zwischen Keyframes
     TimingProfile profile;  // Timing-Profil
     float swingMul;         // Swing-Multiplier
     float stanceMul;        // Stance-Multiplier
@@ -52,6 +76,7 @@ struct WalkParams {
     WalkParams() 
         : stride(1.0f)
         , subSteps(8)
+        , interp(InterpolationMode::SMOOTHSTEP)
         , profile(TimingProfile::SWING_STANCE)
         , swingMul(0.75f)
         , stanceMul(1.25f)
@@ -77,6 +102,15 @@ public:
     void requestStop();
     void forceStop();
     
+    // Sequenz aus /motions/<name>.spm abspielen (wie ein Command eingereiht),
+    // optional gespiegelt/rückwärts (KEYFRAME_* Bitmaske)
+    bool playMotionFile(const char* name, uint8_t transform = 0);
+    
+    // Bewegungsvektor: Vor-, Seit- und Drehgait werden im CPG überlagert,
+    // Amplitude folgt dem Betrag. Nullvektor = Stop nach Zyklus.
+    void setMoveVector(float vx, float vy, float yaw);
+    const MoveVector& getMoveVector() const { return moveVec; }
+    
     // Haupt-Prozessschleife (in loop() aufrufen)
     void processQueue();
     
@@ -87,11 +121,17 @@ public:
     // Live-Parameter-Änderung
     void setStrideFactor(float factor);
     void setSubSteps(uint8_t steps);
+    void setInterpolationMode(InterpolationMode mode);
     void setTimingProfile(TimingProfile profile);
     void setSwingMultiplier(float mult);
     void setStanceMultiplier(float mult);
     void enableRamp(bool enable, uint8_t cycles = 3);
     
+    // Gait-Engine (Wechsel greift an der nächsten Zyklusgrenze)
+    void setGaitEngine(GaitEngine engine);
+    GaitEngine getGaitEngine() const { return gaitEngine; }
+    const char* getGaitEngineName() const;
+    
     // Kalibrierungs-Lock
     void setCalibrationLocked(bool locked);
     bool isCalibrationLocked() const { return calibrationLocked; }
@@ -105,20 +145,41 @@ private:
     // Motion für Command starten (mit GaitRuntime)
     void startMotionForCmd(MotionCmd cmd);
     
-    // Blockierende Commands ausführen (Legacy)
-    void executeCommandBlocking(MotionCmd cmd);
-    
     // Walk-Parameter auf GaitRuntime anwenden
     void applyWalkParams();
     
+    // CPG: Command läuft über den Oszillator?
+    bool usesCpg(MotionCmd cmd);
+    
+    // CPG: Richtung für Command setzen (im Vektor-Modus aus moveVec)
+    void applyCpgCommand(MotionCmd cmd);
+    
+    // Laufende Keyframe-Gangart am nächsten Keyframe-Wechsel beenden,
+    // die Folgebewegung steigt dann am nächstgelegenen Keyframe ein
+    void preemptKeyframeGait();
+    
+    // Keyframe-Gangart bzw. Standby starten (nach Abbruch am nächstgelegenen Keyframe)
+    void startKeyframeGait(const KeyframeTable& table);
+    
+    // Dominante Richtung eines Vektors (für Status/Anzeige)
+    MotionCmd dominantCmd(const MoveVector& v) const;
+    
     // State
     MotionCmd currentCmd;
+    MotionCmd activeGaitCmd;     // Von GaitRuntime gerade abgespielte Sequenz
+    MotionCmd previousGaitCmd;   // Davor abgespielte Sequenz (Soft-Start nur aus dem Stand)
     MotionCmd pendingCmd;
     bool hasPendingCmd;
     bool continuousMode;
     bool stopAfterSequence;
     bool motionRunning;
     bool calibrationLocked;
+    GaitEngine gaitEngine;
+    bool vectorMode;             // Bewegung kommt aus moveVec statt aus Commands
+    MoveVector moveVec;
+    char motionFileName[25];     // Name für MOTIONFILE (max. 24 Zeichen)
+    uint8_t motionFileTransform; // KEYFRAME_* Bitmaske für MOTIONFILE
+    bool enterAtClosest;         // Nächste Gangart am nächstgelegenen Keyframe starten
     
     // Walk-Parameter
     WalkParams walkParams;
@@ -4,6 +4,8 @@
 #include "WebServer_v3.h"
 #include "../robot/RobotController_v3.h"
 #include "../motion/MotionData_v3.h"
+#include "../motion/MotionFile.h"
+#include "../motion/ServoOutput.h"
 #include "../gait/GaitRuntime.h"
 #include "../calibration/ServoCalibration.h"
 
@@ -76,6 +78,12 @@ void handleWebSocketV3(AsyncWebSocket *server, AsyncWebSocketClient *client,
                                 robotController.startContinuous(robotController.parseCommand(name));
                             }
                         }
+                        else if (strcmp(msgType, "moveVec") == 0) {
+                            float vx = doc["vx"] | 0.0f;
+                            float vy = doc["vy"] | 0.0f;
+                            float yaw = doc["yaw"] | 0.0f;
+                            robotController.setMoveVector(vx, vy, yaw);
+                        }
                         else if (strcmp(msgType, "moveStop") == 0) {
                             robotController.requestStop();
                         }
@@ -104,8 +112,10 @@ void handleWebSocketV3(AsyncWebSocket *server, AsyncWebSocketClient *client,
                         // ========== v3 Walk-Parameter Commands ==========
                         else if (strcmp(msgType, "setWalkParams") == 0) {
                             WalkParams params;
+                            params.interp = robotController.getWalkParams().interp;
                             if (doc.containsKey("stride")) params.stride = doc["stride"].as<float>();
                             if (doc.containsKey("subSteps")) params.subSteps = doc["subSteps"].as<uint8_t>();
+                            if (doc.containsKey("interp")) params.interp = (InterpolationMode)doc["interp"].as<int>();
                             if (doc.containsKey("profile")) params.profile = (TimingProfile)doc["profile"].as<int>();
                             if (doc.containsKey("swingMul")) params.swingMul = doc["swingMul"].as<float>();
                             if (doc.containsKey("stanceMul")) params.stanceMul = doc["stanceMul"].as<float>();
@@ -126,6 +136,11 @@ void handleWebSocketV3(AsyncWebSocket *server, AsyncWebSocketClient *client,
                                 robotController.setSubSteps(doc["value"].as<uint8_t>());
                             }
                         }
+                        else if (strcmp(msgType, "setInterpolation") == 0) {
+                            if (doc.containsKey("value")) {
+                                robotController.setInterpolationMode((InterpolationMode)doc["value"].as<int>());
+                            }
+                        }
                         else if (strcmp(msgType, "setTimingProfile") == 0) {
                             if (doc.containsKey("value")) {
                                 robotController.setTimingProfile((TimingProfile)doc["value"].as<int>());
@@ -145,37 +160,166 @@ void handleWebSocketV3(AsyncWebSocket *server, AsyncWebSocketClient *client,
                             bool enabled = doc["enabled"] | false;
                             uint8_t cycles = doc["cycles"] | 3;
                             robotController.enableRamp(enabled, cycles);
+                            if (doc.containsKey("stopSegments")) {
+                                GaitRuntime::setRampStopSegments(doc["stopSegments"] | RAMP_DEFAULT_STOP_SEGMENTS);
+                            }
+                        }
+                        else if (strcmp(msgType, "setEasing") == 0) {
+                            uint8_t profile = doc["profile"] | (uint8_t)robotController.getWalkParams().profile;
+                            if (profile < TIMING_PROFILE_COUNT) {
+                                GaitRuntime::setEasing((TimingProfile)profile,
+                                    (EasingCurve)(doc["hip"] | (int)gaitConfig.easing.hip[profile]),
+                                    (EasingCurve)(doc["knee"] | (int)gaitConfig.easing.knee[profile]));
+                            }
+                            JsonArray custom = doc["custom"];
+                            if (custom.size() == EASING_CUSTOM_POINTS) {
+                                uint8_t points[EASING_CUSTOM_POINTS];
+                                for (uint8_t i = 0; i < EASING_CUSTOM_POINTS; i++) {
+                                    points[i] = custom[i] | 0;
+                                }
+                                GaitRuntime::setEasingCustom(points);
+                            }
+                        }
+                        else if (strcmp(msgType, "setSlewLimits") == 0) {
+                            if (doc.containsKey("enabled")) {
+                                GaitRuntime::enableSlewLimit(doc["enabled"] | true);
+                            }
+                            if (doc.containsKey("velocity") || doc.containsKey("accel")) {
+                                uint8_t servo = doc["servo"] | 0xFF;
+                                uint8_t ref = servo < SERVO_COUNT ? servo : 0;
+                                GaitRuntime::setSlewLimits(servo,
+                                    doc["velocity"] | gaitConfig.slew.maxVelocity[ref],
+                                    doc["accel"] | gaitConfig.slew.maxAccel[ref]);
+                            }
+                        }
+                        else if (strcmp(msgType, "setPwmStagger") == 0) {
+                            GaitRuntime::setPwmStagger(doc["value"] | gaitConfig.pwm.staggerUs);
+                        }
+                        else if (strcmp(msgType, "setCurrentBudget") == 0) {
+                            const CurrentConfig& cur = gaitConfig.current;
+                            GaitRuntime::setCurrentBudget(doc["enabled"] | cur.enabled,
+                                                          doc["budget"] | cur.budgetMa);
+                            if (doc.containsKey("hip") || doc.containsKey("knee")) {
+                                GaitRuntime::setCurrentModel(doc["hip"] | cur.hipMaPer100Dps,
+                                                             doc["knee"] | cur.kneeMaPer100Dps);
+                            }
+                        }
+                        else if (strcmp(msgType, "setGaitEngine") == 0) {
+                            const char* engine = doc["engine"] | "keyframe";
+                            robotController.setGaitEngine(strcmp(engine, "cpg") == 0
+                                ? GaitEngine::CPG : GaitEngine::KEYFRAME);
+                        }
+                        else if (strcmp(msgType, "setCpgParams") == 0) {
+                            const CpgConfig& cpg = gaitConfig.cpg;
+                            if (doc.containsKey("gait")) {
+                                const char* gait = doc["gait"] | "creep";
+                                GaitRuntime::setCpgGaitType(strcmp(gait, "trot") == 0
+                                    ? CpgGaitType::TROT : CpgGaitType::CREEP);
+                            }
+                            GaitRuntime::setCpgParams(
+                                doc["duty"] | cpg.dutyFactor,
+                                doc["stepHeight"] | cpg.stepHeight,
+                                doc["stride"] | cpg.strideDeg,
+                                doc["period"] | cpg.basePeriodMs);
+                            if (doc.containsKey("ik") || doc.containsKey("strideMm")) {
+                                GaitRuntime::setCpgIk(doc["ik"] | cpg.ikEnabled,
+                                                      doc["strideMm"] | cpg.strideMm);
+                            }
+                        }
+                        else if (strcmp(msgType, "setLegGeometry") == 0) {
+                            LegGeometry geo = gaitConfig.leg;
+                            geo.coxaMm = doc["coxa"] | geo.coxaMm;
+                            geo.tibiaMm = doc["tibia"] | geo.tibiaMm;
+                            geo.neutralTiltDeg = doc["tilt"] | geo.neutralTiltDeg;
+                            geo.mountDeg = doc["mount"] | geo.mountDeg;
+                            geo.bodyHalfLengthMm = doc["bodyHalfLength"] | geo.bodyHalfLengthMm;
+                            geo.bodyHalfWidthMm = doc["bodyHalfWidth"] | geo.bodyHalfWidthMm;
+                            GaitRuntime::setLegGeometry(geo);
                         }
                         
                         // ========== v3 Servo-Kalibrierungs-Commands ==========
                         else if (strcmp(msgType, "setServoOffset") == 0) {
                             if (!robotController.isCalibrationLocked()) {
                                 uint8_t servo = doc["servo"] | 0;
-                                int offset = doc["offset"] | 0;
-                                ServoCalibration::setOffset(servo, offset);
+                                if (doc.containsKey("offsetUs")) {
+                                    ServoCalibration::setOffsetUs(servo, doc["offsetUs"].as<int>());
+                                } else {
+                                    int offset = doc["offset"] | 0;
+                                    ServoCalibration::setOffset(servo, offset);
+                                }
                                 broadcastCalibState();
                             }
                         }
                         else if (strcmp(msgType, "setServoLimits") == 0) {
                             if (!robotController.isCalibrationLocked()) {
                                 uint8_t servo = doc["servo"] | 0;
-                                int minAngle = doc["min"] | 20;
-                                int maxAngle = doc["max"] | 160;
-                                int center = doc["center"] | 90;
-                                ServoCalibration::setLimits(servo, minAngle, maxAngle, center);
+                                if (doc.containsKey("minUs")) {
+                                    int minUs = doc["minUs"] | 622;
+                                    int maxUs = doc["maxUs"] | 2178;
+                                    int centerUs = doc["centerUs"] | 1400;
+                                    ServoCalibration::setLimitsUs(servo, minUs, maxUs, centerUs);
+                                } else {
+                                    int minAngle = doc["min"] | 20;
+                                    int maxAngle = doc["max"] | 160;
+                                    int center = doc["center"] | 90;
+                                    ServoCalibration::setLimits(servo, minAngle, maxAngle, center);
+                                }
                                 sendServoLimits(client);
                             }
                         }
                         else if (strcmp(msgType, "setServoCalib") == 0) {
                             if (!robotController.isCalibrationLocked()) {
                                 uint8_t servo = doc["servo"] | 0;
-                                int offset = doc["offset"] | 0;
-                                int minAngle = doc["min"] | 20;
-                                int maxAngle = doc["max"] | 160;
-                                int center = doc["center"] | 90;
                                 
-                                ServoCalibration::setOffset(servo, offset);
-                                ServoCalibration::setLimits(servo, minAngle, maxAngle, center);
+                                // Einzelner Messpunkt [Grad, µs] oder Punkt entfernen:
+                                // Offset und Limits bleiben, der Servo fährt zum Messen hin
+                                if (doc.containsKey("point") || doc.containsKey("removePoint")) {
+                                    int angle;
+                                    if (doc.containsKey("point")) {
+                                        angle = doc["point"][0] | 90;
+                                        ServoCalibration::setPoint(servo, angle, doc["point"][1] | 0);
+                                    } else {
+                                        angle = doc["removePoint"] | 90;
+                                        ServoCalibration::removePoint(servo, angle);
+                                    }
+                                    if (servo < SERVO_COUNT && !robotController.isMoving()) {
+                                        Set_PWM_to_Servo(servo, angle);
+                                        Running_Servo_POS[servo] = angle;
+                                    }
+                                } else {
+                                    int offset = doc["offset"] | 0;
+                                    int minAngle = doc["min"] | 20;
+                                    int maxAngle = doc["max"] | 160;
+                                    int center = doc["center"] | 90;
+                                    
+                                    if (doc.containsKey("offsetUs")) {
+                                        ServoCalibration::setOffsetUs(servo, doc["offsetUs"].as<int>());
+                                    } else {
+                                        ServoCalibration::setOffset(servo, offset);
+                                    }
+                                    ServoCalibration::setLimits(servo, minAngle, maxAngle, center);
+                                    
+                                    // Messpunkte komplett ersetzen ([] löscht)
+                                    if (doc.containsKey("points")) {
+                                        ServoCalibration::CalibPoint points[ServoCalibration::CALIB_MAX_POINTS];
+                                        uint8_t count = 0;
+                                        for (JsonVariant p : doc["points"].as<JsonArray>()) {
+                                            if (count >= ServoCalibration::CALIB_MAX_POINTS) break;
+                                            points[count].angle = p[0] | 90;
+                                            points[count].us = p[1] | 0;
+                                            count++;
+                                        }
+                                        ServoCalibration::setPoints(servo, points, count);
+                                    }
+                                    
+                                    // Einzelne Punkte ändern bzw. entfernen, übrige bleiben
+                                    for (JsonVariant p : doc["mergePoints"].as<JsonArray>()) {
+                                        ServoCalibration::setPoint(servo, p[0] | 90, p[1] | 0);
+                                    }
+                                    for (JsonVariant a : doc["removePoints"].as<JsonArray>()) {
+                                        ServoCalibration::removePoint(servo, a | 90);
+                                    }
+                                }
                                 broadcastCalibState();
                             }
                         }
@@ -208,6 +352,89 @@ void handleWebSocketV3(AsyncWebSocket *server, AsyncWebSocketClient *client,
                         else if (strcmp(msgType, "getServoCalib") == 0) {
                             sendAllServoCalib(client);
                         }
+                        else if (strcmp(msgType, "benchGait") == 0) {
+                            GaitRuntime::BenchmarkResult r = GaitRuntime::benchmark(Servo_Prg_2);
+                            JsonDocument resp;
+                            resp["type"] = "gaitBench";
+                            resp["fixedPoint"] = (bool)GAIT_FIXED_POINT;
+                            resp["floatCycles"] = r.floatCycles;
+                            resp["fixedCycles"] = r.fixedCycles;
+                            resp["maxAngleDiff"] = r.maxDiffFine / (float)ANGLE_FINE_ONE;
+                            String output;
+                            serializeJson(resp, output);
+                            client->text(output);
+                        }
+                        else if (strcmp(msgType, "getServoStats") == 0) {
+                            const ServoWriteStats& st = getServoWriteStats();
+                            JsonDocument resp;
+                            resp["type"] = "servoStats";
+                            resp["issued"] = st.issued;
+                            resp["skipped"] = st.skipped;
+                            resp["slewSteps"] = st.slewSteps;
+                            resp["velocityLimited"] = st.velocityLimited;
+                            resp["accelLimited"] = st.accelLimited;
+                            JsonArray limited = resp["limited"].to<JsonArray>();
+                            for (int i = 0; i < 8; i++) {
+                                limited.add(st.limited[i]);
+                            }
+                            const GaitRuntime::SegmentCacheStats& cache = GaitRuntime::getSegmentCacheStats();
+                            JsonObject segmentCache = resp["segmentCache"].to<JsonObject>();
+                            segmentCache["hits"] = cache.hits;
+                            segmentCache["misses"] = cache.misses;
+                            segmentCache["invalidations"] = cache.invalidations;
+                            ServoOutput::FrameStats fs;
+                            ServoOutput::getStats(fs);
+                            JsonObject frame = resp["frame"].to<JsonObject>();
+                            frame["frames"] = fs.frames;
+                            frame["fresh"] = fs.fresh;
+                            frame["resyncs"] = fs.resyncs;
+                            frame["commits"] = fs.commits;
+                            frame["maxJitterUs"] = fs.maxJitterUs;
+                            frame["maxCommitGapUs"] = fs.maxCommitGapUs;
+                            JsonArray jitter = frame["jitter"].to<JsonArray>();
+                            for (int i = 0; i < ServoOutput::FRAME_JITTER_BUCKETS; i++) {
+                                jitter.add(fs.histogram[i]);
+                            }
+                            frame["staggerUs"] = gaitConfig.pwm.staggerUs;
+                            frame["pulses"] = fs.pulses;
+                            frame["riseLateMaxUs"] = fs.riseLateMaxUs;
+                            frame["widthErrMaxUs"] = fs.widthErrMaxUs;
+                            frame["widthErrAvgUs"] = fs.pulses ? fs.widthErrSumTenthUs / 10.0f / fs.pulses : 0.0f;
+                            frame["maxConcurrent"] = fs.maxConcurrent;
+                            const GaitRuntime::CurrentStats& cs = GaitRuntime::getCurrentStats();
+                            JsonObject current = resp["current"].to<JsonObject>();
+                            current["budgetMa"] = gaitConfig.current.enabled ? gaitConfig.current.budgetMa : 0;
+                            current["cyclePeakMa"] = cs.cyclePeakMa;
+                            current["cycleAvgMa"] = cs.cycleAvgMa;
+                            current["cycles"] = cs.cycles;
+                            current["shiftedLegs"] = cs.shiftedLegs;
+                            current["stretchedSegments"] = cs.stretchedSegments;
+                            current["overBudget"] = cs.overBudget;
+                            String output;
+                            serializeJson(resp, output);
+                            client->text(output);
+                            if (doc["reset"] | false) {
+                                resetServoWriteStats();
+                                ServoOutput::resetStats();
+                                GaitRuntime::resetCurrentStats();
+                            }
+                        }
+                        else if (strcmp(msgType, "playMotion") == 0) {
+                            const char* name = doc["name"];
+                            uint8_t transform = 0;
+                            if (doc["mirror"] | false) transform |= KEYFRAME_MIRROR_LR;
+                            if (doc["reverse"] | false) transform |= KEYFRAME_REVERSED;
+                            if (!robotController.playMotionFile(name, transform)) {
+                                Serial.println(F("[WS] playMotion: ungültiger Name"));
+                            }
+                        }
+                        else if (strcmp(msgType, "listMotions") == 0) {
+                            sendMotionList(client);
+                        }
+                        else if (strcmp(msgType, "deleteMotion") == 0) {
+                            MotionFile::remove(doc["name"]);
+                            sendMotionList(client);
+                        }
                         else if (strcmp(msgType, "shutdown") == 0) {
                             performShutdown();
                         }
@@ -235,21 +462,35 @@ void broadcastTerrainStatus() {
     ws.textAll(output);
 }
 
+// Messpunkte eines Servos als [[Grad, µs], ...]
+static void addCalibPoints(JsonArray list, uint8_t servo) {
+    for (uint8_t k = 0; k < ServoCalibration::getPointCount(servo); k++) {
+        ServoCalibration::CalibPoint p = ServoCalibration::getPoint(servo, k);
+        JsonArray pair = list.add<JsonArray>();
+        pair.add(p.angle);
+        pair.add(p.us);
+    }
+}
+
 void broadcastCalibState() {
     JsonDocument doc;
     doc["type"] = "calibState";
     doc["locked"] = robotController.isCalibrationLocked();
     
     JsonArray offsets = doc["offsets"].to<JsonArray>();
+    JsonArray offsetsUs = doc["offsetsUs"].to<JsonArray>();
     JsonArray mins = doc["mins"].to<JsonArray>();
     JsonArray maxs = doc["maxs"].to<JsonArray>();
     JsonArray centers = doc["centers"].to<JsonArray>();
+    JsonArray points = doc["points"].to<JsonArray>();
     
     for (int i = 0; i < 8; i++) {
         offsets.add(ServoCalibration::getOffset(i));
+        offsetsUs.add(ServoCalibration::getOffsetUs(i));
         mins.add(ServoCalibration::getMinAngle(i));
         maxs.add(ServoCalibration::getMaxAngle(i));
         centers.add(ServoCalibration::getCenterAngle(i));
+        addCalibPoints(points.add<JsonArray>(), i);
     }
     
     String output;
@@ -264,6 +505,7 @@ void broadcastWalkParams() {
     const WalkParams& p = robotController.getWalkParams();
     doc["stride"] = p.stride;
     doc["subSteps"] = p.subSteps;
+    doc["interp"] = (int)p.interp;
     doc["profile"] = (int)p.profile;
     doc["swingMul"] = p.swingMul;
     doc["stanceMul"] = p.stanceMul;
@@ -297,6 +539,7 @@ void sendWalkParams(AsyncWebSocketClient *client) {
     const WalkParams& p = robotController.getWalkParams();
     doc["stride"] = p.stride;
     doc["subSteps"] = p.subSteps;
+    doc["interp"] = (int)p.interp;
     doc["profile"] = (int)p.profile;
     doc["swingMul"] = p.swingMul;
     doc["stanceMul"] = p.stanceMul;
@@ -336,9 +579,13 @@ void sendAllServoCalib(AsyncWebSocketClient *client) {
         JsonObject servo = servos.add<JsonObject>();
         servo["servo"] = i;
         servo["offset"] = ServoCalibration::getOffset(i);
+        servo["offsetUs"] = ServoCalibration::getOffsetUs(i);
+        servo["minUs"] = ServoCalibration::getMinUs(i);
+        servo["maxUs"] = ServoCalibration::getMaxUs(i);
         servo["min"] = ServoCalibration::getMinAngle(i);
         servo["max"] = ServoCalibration::getMaxAngle(i);
         servo["center"] = ServoCalibration::getCenterAngle(i);
+        addCalibPoints(servo["points"].to<JsonArray>(), i);
     }
     
     String output;
@@ -347,6 +594,28 @@ void sendAllServoCalib(AsyncWebSocketClient *client) {
     Serial.println(F("[WS] Sent allServoCalib"));
 }
 
+static void addMotionEntry(const char* name, uint16_t keyframes, void* ctx) {
+    JsonArray motions = *(JsonArray*)ctx;
+    JsonObject motion = motions.add<JsonObject>();
+    motion["name"] = name;
+    motion["keyframes"] = keyframes;
+}
+
+static void fillMotionList(JsonDocument& doc) {
+    JsonArray motions = doc["motions"].to<JsonArray>();
+    MotionFile::list(addMotionEntry, &motions);
+}
+
+void sendMotionList(AsyncWebSocketClient *client) {
+    JsonDocument doc;
+    doc["type"] = "motionList";
+    fillMotionList(doc);
+    
+    String output;
+    serializeJson(doc, output);
+    client->text(output);
+}
+
 // =============================================================================
 // API Routes
 // =============================================================================
@@ -358,6 +627,9 @@ void setupApiRoutes() {
         doc["uptime"] = millis();
         doc["clients"] = ws.count();
         doc["moving"] = robotController.isMoving();
+        doc["gaitEngine"] = robotController.getGaitEngineName();
+        doc["servoWrites"] = getServoWriteStats().issued;
+        doc["servoWritesSkipped"] = getServoWriteStats().skipped;
         
         String response;
         serializeJson(doc, response);
@@ -391,6 +663,52 @@ void setupApiRoutes() {
         request->send(200, "application/json", "{\"status\":\"ok\"}");
     });
     
+    // Motion-Datei hochladen: POST /api/motion/upload?name=<name>, Body = Binärdatei.
+    // Der Body kommt in Blöcken und wird direkt auf LittleFS geschrieben.
+    static bool motionUploadOk = false;
+    webServer.on("/api/motion/upload", HTTP_POST,
+        [](AsyncWebServerRequest *request) {
+            if (motionUploadOk) {
+                request->send(200, "application/json", "{\"status\":\"ok\"}");
+            } else {
+                request->send(400, "application/json", "{\"error\":\"Invalid motion file\"}");
+            }
+            motionUploadOk = false;
+        },
+        NULL,
+        [](AsyncWebServerRequest *request, uint8_t *data, size_t len, size_t index, size_t total) {
+            if (index == 0) {
+                const AsyncWebParameter* name = request->getParam("name");
+                motionUploadOk = name && MotionFile::beginUpload(name->value().c_str());
+            }
+            if (motionUploadOk) {
+                motionUploadOk = MotionFile::writeChunk(data, len);
+            }
+            if (index + len == total) {
+                motionUploadOk = motionUploadOk ? MotionFile::finishUpload() : false;
+                if (!motionUploadOk) MotionFile::abortUpload();
+            }
+        }
+    );
+    
+    webServer.on("/api/motions", HTTP_GET, [](AsyncWebServerRequest *request) {
+        JsonDocument doc;
+        fillMotionList(doc);
+        
+        String response;
+        serializeJson(doc, response);
+        request->send(200, "application/json", response);
+    });
+    
+    webServer.on("/api/motion", HTTP_DELETE, [](AsyncWebServerRequest *request) {
+        const AsyncWebParameter* name = request->getParam("name");
+        if (name && MotionFile::remove(name->value().c_str())) {
+            request->send(200, "application/json", "{\"status\":\"ok\"}");
+        } else {
+            request->send(404, "application/json", "{\"error\":\"Motion not found\"}");
+        }
+    });
+    
     webServer.on("/api/walkparams", HTTP_GET, [](AsyncWebServerRequest *request) {
         JsonDocument doc;
         const WalkParams& p = robotController.getWalkParams();
@@ -469,6 +787,7 @@ void performShutdown() {
     delay(200);
     
     sleep();
+    servoSlewSettle(2000);
     delay(500);
     
     ServoCalibration::save();
@@ -6,6 +6,7 @@
 //   - setWalkParams Command
 //   - Servo-Kalibrierungs-Commands (Limits, Center)
 //   - GaitRuntime-Integration
+//   - Upload/Wiedergabe binärer Motion-Dateien (MotionFile)
 // =============================================================================
 #ifndef WEB_SERVER_V3_H
 #define WEB_SERVER_V3_H
@@ -29,6 +30,7 @@ void sendCalibState(AsyncWebSocketClient *client);
 void sendWalkParams(AsyncWebSocketClient *client);
 void sendServoLimits(AsyncWebSocketClient *client);
 void sendAllServoCalib(AsyncWebSocketClient *client);
+void sendMotionList(AsyncWebSocketClient *client);
 
 // Setup
 void setupApiRoutes();